@@ -0,0 +1,115 @@
+#ifndef ARRAY_EXPRESSION_H
+#define ARRAY_EXPRESSION_H
+
+#include <cstddef>
+#include <type_traits>
+#include "array_kernels.h"
+
+// Ленивые выражения над массивами: a + b - c + d не создает промежуточных
+// массивов, а вычисляется одним проходом при присваивании результата.
+// Каждый шаг ограничивается диапазоном [-100, 100] так же, как add/subtract,
+// а за концом более короткого операнда используется 0.
+// Выражение хранит указатели на данные массивов, поэтому его нужно присвоить
+// массиву до изменения или уничтожения операндов
+
+template <typename T, typename Allocator>
+class BasicDynamicArray;
+
+// Лист выражения: данные массива
+template <typename T>
+struct ArrayLeaf {
+    const T* data;
+    size_t length;
+
+    size_t size() const { return length; }
+    // Длина, на которой определены все операнды (проверки границ не нужны)
+    size_t commonSize() const { return length; }
+    int valueUnchecked(size_t i) const { return data[i]; }
+    int value(size_t i) const { return (i < length) ? data[i] : 0; }
+};
+
+// Узел выражения: сумма или разность двух подвыражений с ограничением
+template <typename Left, typename Right, bool Subtract>
+struct ArrayOperation {
+    Left left;
+    Right right;
+
+    size_t size() const {
+        size_t a = left.size();
+        size_t b = right.size();
+        return (a > b) ? a : b;
+    }
+
+    size_t commonSize() const {
+        size_t a = left.commonSize();
+        size_t b = right.commonSize();
+        return (a < b) ? a : b;
+    }
+
+    int valueUnchecked(size_t i) const {
+        int a = left.valueUnchecked(i);
+        int b = right.valueUnchecked(i);
+        return clampValue(Subtract ? a - b : a + b);
+    }
+
+    int value(size_t i) const {
+        int a = left.value(i);
+        int b = right.value(i);
+        return clampValue(Subtract ? a - b : a + b);
+    }
+};
+
+template <typename E>
+struct IsArrayOperation : std::false_type {};
+
+template <typename Left, typename Right, bool Subtract>
+struct IsArrayOperation<ArrayOperation<Left, Right, Subtract> > : std::true_type {};
+
+template <typename E>
+struct IsArrayOperand : IsArrayOperation<E> {};
+
+template <typename T, typename Allocator>
+struct IsArrayOperand<BasicDynamicArray<T, Allocator> > : std::true_type {};
+
+template <typename T, typename Allocator>
+ArrayLeaf<T> asExpression(const BasicDynamicArray<T, Allocator>& array) {
+    return ArrayLeaf<T>{array.rawData(), array.getSize()};
+}
+
+template <typename Left, typename Right, bool Subtract>
+const ArrayOperation<Left, Right, Subtract>& asExpression(const ArrayOperation<Left, Right, Subtract>& operation) {
+    return operation;
+}
+
+template <typename E>
+using ExpressionOf = typename std::decay<decltype(asExpression(std::declval<const E&>()))>::type;
+
+template <typename A, typename B>
+using EnableIfOperands = typename std::enable_if<IsArrayOperand<A>::value && IsArrayOperand<B>::value>::type;
+
+template <typename A, typename B, typename = EnableIfOperands<A, B> >
+ArrayOperation<ExpressionOf<A>, ExpressionOf<B>, false> operator+(const A& a, const B& b) {
+    return ArrayOperation<ExpressionOf<A>, ExpressionOf<B>, false>{asExpression(a), asExpression(b)};
+}
+
+template <typename A, typename B, typename = EnableIfOperands<A, B> >
+ArrayOperation<ExpressionOf<A>, ExpressionOf<B>, true> operator-(const A& a, const B& b) {
+    return ArrayOperation<ExpressionOf<A>, ExpressionOf<B>, true>{asExpression(a), asExpression(b)};
+}
+
+// Вычисление выражения в out[0..size()): сначала общая часть без проверок
+// границ (цикл векторизуется), затем хвост с нулями вместо коротких операндов.
+// out может совпадать с данными операнда: i-й результат зависит только от i-х элементов
+template <typename T, typename E>
+void evaluateExpression(const E& expression, T* out) {
+    size_t common = expression.commonSize();
+    size_t total = expression.size();
+    for (size_t i = 0; i < common; ++i) {
+        out[i] = static_cast<T>(expression.valueUnchecked(i));
+    }
+    for (size_t i = common; i < total; ++i) {
+        out[i] = static_cast<T>(expression.value(i));
+    }
+}
+
+#endif
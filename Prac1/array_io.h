@@ -0,0 +1,78 @@
+#ifndef ARRAY_IO_H
+#define ARRAY_IO_H
+
+#include <charconv>
+#include <cstddef>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Массовый ввод и вывод значений DynamicArray: поток читается целиком
+// в одну строку и разбирается std::from_chars, вывод собирается в один
+// буфер через std::to_chars и записывается одной операцией
+
+const size_t READ_BLOCK_BYTES = 1 << 20;
+
+inline std::string readAll(std::istream& in) {
+    std::string text;
+    for (;;) {
+        size_t used = text.size();
+        text.resize(used + READ_BLOCK_BYTES);
+        in.read(&text[used], READ_BLOCK_BYTES);
+        text.resize(used + static_cast<size_t>(in.gcount()));
+        if (!in) break;
+    }
+    return text;
+}
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+// Целые числа через пробельные символы; диапазон значений не проверяется
+inline void parseValues(const std::string& text, std::vector<int>& values) {
+    const char* current = text.data();
+    const char* end = current + text.size();
+    values.reserve(values.size() + text.size() / 2);
+    for (;;) {
+        while (current != end && isSpace(*current)) {
+            ++current;
+        }
+        if (current == end) break;
+        int value = 0;
+        std::from_chars_result result = std::from_chars(current, end, value);
+        if (result.ec != std::errc() || (result.ptr != end && !isSpace(*result.ptr))) {
+            throw std::invalid_argument("Некорректное число во входных данных");
+        }
+        values.push_back(value);
+        current = result.ptr;
+    }
+}
+
+// Значения через separator в конец out. Место отводится под самое длинное
+// значение типа T, а не только под [-100, 100]: в отображенном файле
+// могут оказаться любые числа
+template <typename T>
+void formatValues(const T* values, size_t count, const char* separator, std::string& out) {
+    const size_t maxValueChars = std::numeric_limits<T>::digits10 + 2;
+    size_t separatorLength = std::char_traits<char>::length(separator);
+    size_t used = out.size();
+    out.resize(used + count * (maxValueChars + separatorLength));
+    char* current = &out[0] + used;
+    char* end = &out[0] + out.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            current = std::copy(separator, separator + separatorLength, current);
+        }
+        std::to_chars_result result = std::to_chars(current, end, static_cast<int>(values[i]));
+        if (result.ec != std::errc()) {
+            throw std::length_error("Недостаточно места для вывода значений");
+        }
+        current = result.ptr;
+    }
+    out.resize(static_cast<size_t>(current - out.data()));
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef ARRAY_KERNELS_H
+#define ARRAY_KERNELS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX512BW__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Поэлементные операции над буферами DynamicArray: out[i] = a[i] +/- b[i]
+// с ограничением результата диапазоном [-100, 100].
+// Значения в буферах уже лежат в этом диапазоне
+
+inline int clampValue(int value) {
+    return std::min(100, std::max(-100, value));
+}
+
+// Хранение int: цикл без ветвлений векторизуется компилятором
+inline void addClamped(const int* a, const int* b, int* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = clampValue(a[i] + b[i]);
+    }
+}
+
+inline void subtractClamped(const int* a, const int* b, int* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = clampValue(a[i] - b[i]);
+    }
+}
+
+#if defined(__SSE2__)
+inline __m128i clamp128(__m128i r, __m128i low, __m128i high) {
+#if defined(__SSE4_1__)
+    return _mm_min_epi8(_mm_max_epi8(r, low), high);
+#else
+    // В SSE2 нет min/max для int8: замена по маске сравнения
+    __m128i below = _mm_cmplt_epi8(r, low);
+    __m128i above = _mm_cmpgt_epi8(r, high);
+    r = _mm_or_si128(_mm_andnot_si128(below, r), _mm_and_si128(below, low));
+    return _mm_or_si128(_mm_andnot_si128(above, r), _mm_and_si128(above, high));
+#endif
+}
+#endif
+
+// Хранение int8_t: сложение с насыщением (результат остается в [-128, 127],
+// поэтому выход за +/-100 сохраняется), затем ограничение +/-100.
+// 64 (AVX-512BW), 32 (AVX2) или 16 (SSE2) элементов за инструкцию
+template <bool Subtract>
+inline void saturatingKernel(const int8_t* a, const int8_t* b, int8_t* out, size_t n) {
+    size_t i = 0;
+#if defined(__AVX512BW__)
+    const __m512i low512 = _mm512_set1_epi8(-100);
+    const __m512i high512 = _mm512_set1_epi8(100);
+    for (; i + 64 <= n; i += 64) {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i y = _mm512_loadu_si512(b + i);
+        __m512i r = Subtract ? _mm512_subs_epi8(x, y) : _mm512_adds_epi8(x, y);
+        _mm512_storeu_si512(out + i, _mm512_min_epi8(_mm512_max_epi8(r, low512), high512));
+    }
+#endif
+#if defined(__AVX2__)
+    const __m256i low256 = _mm256_set1_epi8(-100);
+    const __m256i high256 = _mm256_set1_epi8(100);
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i r = Subtract ? _mm256_subs_epi8(x, y) : _mm256_adds_epi8(x, y);
+        r = _mm256_min_epi8(_mm256_max_epi8(r, low256), high256);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i low128 = _mm_set1_epi8(-100);
+    const __m128i high128 = _mm_set1_epi8(100);
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i r = Subtract ? _mm_subs_epi8(x, y) : _mm_adds_epi8(x, y);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), clamp128(r, low128, high128));
+    }
+#endif
+    for (; i < n; ++i) {
+        int value = Subtract ? a[i] - b[i] : a[i] + b[i];
+        out[i] = static_cast<int8_t>(clampValue(value));
+    }
+}
+
+inline void addClamped(const int8_t* a, const int8_t* b, int8_t* out, size_t n) {
+    saturatingKernel<false>(a, b, out, n);
+}
+
+inline void subtractClamped(const int8_t* a, const int8_t* b, int8_t* out, size_t n) {
+    saturatingKernel<true>(a, b, out, n);
+}
+
+// Хвост более длинного массива, когда второй операнд равен нулю:
+// a + 0 и a - 0 дают a, 0 - b дает -b (ограничение не нужно)
+template <typename T>
+inline void negateValues(const T* b, T* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<T>(-b[i]);
+    }
+}
+
+#endif
@@ -0,0 +1,256 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "dynamic_array.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+// Замер основных операций DynamicArray и CompactDynamicArray в сравнении
+// с таким же кодом на std::vector<int> (с теми же проверками значений и индексов).
+// bench [maxElements] [seconds] [container]: размеры 16, 256, ... 16^6 и 10^8,
+// не больше maxElements; seconds - минимальное время замера одного варианта;
+// container - vector, dynamic или compact (по умолчанию все).
+// Результат выводится в формате CSV: время на элемент, байты, выделенные
+// за одно повторение, и пиковый RSS процесса на момент замера. RSS только
+// растет, поэтому для сравнения памяти контейнеры запускаются по отдельности;
+// без getrusage (Windows) вместо него выводится -1
+
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t bytes) {
+    allocatedBytes += bytes;
+    void* memory = malloc(bytes > 0 ? bytes : 1);
+    if (!memory) throw bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+// Поток без вывода: форматирование в print выполняется полностью
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+
+    streamsize xsputn(const char*, streamsize count) override {
+        return count;
+    }
+};
+
+static long peakRssKb() {
+#ifdef _WIN32
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+    return usage.ru_maxrss;
+#endif
+}
+
+// Значения и индексы без обращений к памяти: линейный конгруэнтный генератор
+struct Random {
+    unsigned long long state;
+
+    unsigned next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<unsigned>(state >> 32);
+    }
+
+    int value() {
+        return static_cast<int>(next() % 201) - 100;
+    }
+
+    size_t index(size_t count) {
+        return static_cast<size_t>((static_cast<unsigned long long>(next()) * count) >> 32);
+    }
+};
+
+static void checkValue(int value) {
+    if (value < -100 || value > 100) {
+        throw invalid_argument("Значение должно быть в диапазоне от -100 до 100");
+    }
+}
+
+struct VectorOps {
+    typedef vector<int> Array;
+
+    static const char* name() { return "vector<int>"; }
+    static Array make(size_t count) { return Array(count); }
+    static void pushBack(Array& array, int value) { checkValue(value); array.push_back(value); }
+    static void setValue(Array& array, size_t index, int value) { checkValue(value); array.at(index) = value; }
+    static int getValue(const Array& array, size_t index) { return array.at(index); }
+
+    static Array combine(const Array& a, const Array& b, bool subtract) {
+        Array result(max(a.size(), b.size()));
+        for (size_t i = 0; i < result.size(); ++i) {
+            int x = (i < a.size()) ? a[i] : 0;
+            int y = (i < b.size()) ? b[i] : 0;
+            result[i] = clampValue(subtract ? x - y : x + y);
+        }
+        return result;
+    }
+
+    static Array add(const Array& a, const Array& b) { return combine(a, b, false); }
+    static Array subtract(const Array& a, const Array& b) { return combine(a, b, true); }
+
+    // Как исходный DynamicArray::print: каждое значение через operator<<
+    static void print(const Array& array) {
+        cout << "Массив [размер: " << array.size() << "]: ";
+        for (size_t i = 0; i < array.size(); ++i) {
+            cout << array[i];
+            if (i < array.size() - 1) {
+                cout << ", ";
+            }
+        }
+        cout << endl;
+    }
+};
+
+template <typename T>
+struct DynamicOps {
+    typedef BasicDynamicArray<T> Array;
+
+    static const char* name() { return sizeof(T) == 1 ? "CompactDynamicArray" : "DynamicArray"; }
+    static Array make(size_t count) { return Array(count); }
+    static void pushBack(Array& array, int value) { array.pushBack(value); }
+    static void setValue(Array& array, size_t index, int value) { array.setValue(index, value); }
+    static int getValue(const Array& array, size_t index) { return array.getValue(index); }
+    static Array add(const Array& a, const Array& b) { return a.add(b); }
+    static Array subtract(const Array& a, const Array& b) { return a.subtract(b); }
+    static void print(const Array& array) { array.print(); }
+};
+
+struct Bench {
+    double minSeconds;
+    long long checksum;
+
+    template <typename Fn>
+    void measure(const char* operation, const char* container, size_t count, Fn fn) {
+        double seconds = 0;
+        size_t iterations = 0;
+        size_t bytes = 0;
+        do {
+            allocatedBytes = 0;
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            fn();
+            seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            bytes = allocatedBytes;
+            ++iterations;
+        } while (seconds < minSeconds);
+        cout << operation << "," << container << "," << count << "," << iterations << ","
+             << seconds * 1e9 / (static_cast<double>(iterations) * count) << ","
+             << bytes << "," << peakRssKb() << "\n";
+    }
+
+    template <typename Ops>
+    void run(size_t count) {
+        typedef typename Ops::Array Array;
+        const char* name = Ops::name();
+        Random random = {count};
+
+        Array a = Ops::make(count);
+        Array b = Ops::make(count);
+        for (size_t i = 0; i < count; ++i) {
+            Ops::setValue(a, i, random.value());
+            Ops::setValue(b, i, random.value());
+        }
+
+        measure("push_back", name, count, [&]() {
+            Array pushed = Ops::make(0);
+            for (size_t i = 0; i < count; ++i) {
+                Ops::pushBack(pushed, static_cast<int>(i % 201) - 100);
+            }
+            checksum += Ops::getValue(pushed, count - 1);
+        });
+
+        measure("copy", name, count, [&]() {
+            Array copy(a);
+            checksum += Ops::getValue(copy, count / 2);
+        });
+
+        Array target = Ops::make(count);
+        measure("assign", name, count, [&]() {
+            target = b;
+            checksum += Ops::getValue(target, count / 2);
+        });
+
+        measure("add", name, count, [&]() {
+            Array sum = Ops::add(a, b);
+            checksum += Ops::getValue(sum, count / 2);
+        });
+
+        measure("subtract", name, count, [&]() {
+            Array difference = Ops::subtract(a, b);
+            checksum += Ops::getValue(difference, count / 2);
+        });
+
+        measure("random_access", name, count, [&]() {
+            for (size_t i = 0; i < count; ++i) {
+                int value = Ops::getValue(a, random.index(count));
+                Ops::setValue(a, random.index(count), value);
+            }
+            checksum += Ops::getValue(a, count / 2);
+        });
+
+        NullBuffer nullBuffer;
+        measure("print", name, count, [&]() {
+            streambuf* original = cout.rdbuf(&nullBuffer);
+            Ops::print(a);
+            cout.rdbuf(original);
+        });
+    }
+};
+
+int main(int argc, char* argv[]) {
+    size_t maxCount = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 100000000;
+    Bench bench;
+    bench.minSeconds = (argc > 2) ? atof(argv[2]) : 0.2;
+    bench.checksum = 0;
+    string container = (argc > 3) ? argv[3] : "all";
+    bool runVector = container == "all" || container == "vector";
+    bool runDynamic = container == "all" || container == "dynamic";
+    bool runCompact = container == "all" || container == "compact";
+    if (!runVector && !runDynamic && !runCompact) {
+        cerr << "Unknown container: " << container << endl;
+        return 1;
+    }
+
+    vector<size_t> sizes;
+    for (size_t count = 16; count <= maxCount && count <= (1 << 24); count *= 16) {
+        sizes.push_back(count);
+    }
+    if (maxCount >= 100000000) {
+        sizes.push_back(100000000);
+    }
+    if (sizes.empty()) {
+        cerr << "Maximum number of elements must be at least 16" << endl;
+        return 1;
+    }
+
+    cout << "operation,container,elements,iterations,ns_per_element,bytes_allocated,peak_rss_kb\n";
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (runVector) bench.run<VectorOps>(sizes[i]);
+        if (runDynamic) bench.run<DynamicOps<int> >(sizes[i]);
+        if (runCompact) bench.run<DynamicOps<int8_t> >(sizes[i]);
+        cout.flush();
+    }
+    cerr << "checksum " << bench.checksum << endl;
+    return 0;
+}
@@ -0,0 +1,656 @@
+#ifndef DYNAMIC_ARRAY_H
+#define DYNAMIC_ARRAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "array_expression.h"
+#include "array_io.h"
+#include "array_kernels.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+// Режим выполнения поэлементных операций и свертки
+enum class ExecutionMode { Serial, Parallel };
+
+// Массивы короче порога обрабатываются последовательно даже в режиме Parallel
+const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+// Размер части работы одного потока (помещается в кэш L2)
+const size_t PARALLEL_CHUNK_BYTES = 256 << 10;
+
+// Размер встроенного буфера: массивы до 16 int (64 int8_t) не выделяют память
+const size_t INLINE_BYTES = 64;
+
+// Заголовок файла отображенного массива, за ним - элементы.
+// Длина обновляется при каждом изменении размера, поэтому лишняя емкость
+// в конце файла не считается данными, даже если процесс завершился без sync()
+struct MappedArrayHeader {
+    char magic[4];  // "DYN1"
+    uint32_t elementSize;
+    uint64_t count;
+};
+
+const char MAPPED_ARRAY_MAGIC[4] = {'D', 'Y', 'N', '1'};
+
+// Динамический массив значений от -100 до 100.
+// T - тип хранения: int или int8_t (в 4 раза меньше памяти, SIMD-арифметика).
+// Allocator выделяет буферы, не помещающиеся во встроенный.
+// Массив из openMapped хранит элементы в отображенном файле
+template <typename T, typename Allocator = std::allocator<T> >
+class BasicDynamicArray {
+private:
+    template <typename U, typename A>
+    friend class BasicDynamicArray;
+
+    typedef std::allocator_traits<Allocator> AllocatorTraits;
+
+    static const size_t INLINE_CAPACITY = INLINE_BYTES / sizeof(T);
+
+    Allocator allocator;
+    T* data;
+    size_t size;
+    size_t capacity;
+    ExecutionMode execution;
+    T inlineBuffer[INLINE_CAPACITY];
+    // Файл, в котором лежат элементы (только у массивов из openMapped)
+    std::unique_ptr<MappedFile> mapping;
+
+    struct Uninitialized {};
+
+    // Буфер без заполнения, элементы записывает вызывающий код
+    BasicDynamicArray(size_t arraySize, Uninitialized, ExecutionMode mode, const Allocator& alloc)
+        : allocator(alloc), data(nullptr), size(arraySize), capacity(0), execution(mode) {
+        data = allocateBuffer(arraySize, capacity);
+    }
+
+    bool isInline() const {
+        return data == inlineBuffer;
+    }
+
+    // Буфер не меньше count элементов; его емкость записывается в bufferCapacity
+    T* allocateBuffer(size_t count, size_t& bufferCapacity) {
+        if (count <= INLINE_CAPACITY) {
+            bufferCapacity = INLINE_CAPACITY;
+            return inlineBuffer;
+        }
+        bufferCapacity = count;
+        return AllocatorTraits::allocate(allocator, count);
+    }
+
+    void releaseBuffer(T* buffer, size_t bufferCapacity) {
+        if (buffer != inlineBuffer) {
+            AllocatorTraits::deallocate(allocator, buffer, bufferCapacity);
+        }
+    }
+
+    // Забирает буфер или файл other (встроенный буфер копируется), other становится пустым.
+    // Режим выполнения не меняется
+    void takeStorage(BasicDynamicArray& other) {
+        if (other.mapping) {
+            data = other.data;
+            capacity = other.capacity;
+            mapping = std::move(other.mapping);
+        } else if (other.isInline()) {
+            data = inlineBuffer;
+            capacity = INLINE_CAPACITY;
+            std::copy(other.data, other.data + other.size, data);
+        } else {
+            data = other.data;
+            capacity = other.capacity;
+        }
+        size = other.size;
+        other.data = other.inlineBuffer;
+        other.size = 0;
+        other.capacity = INLINE_CAPACITY;
+    }
+
+    static size_t chunkLength() {
+        return PARALLEL_CHUNK_BYTES / sizeof(T);
+    }
+
+    size_t chunkCount(size_t count) const {
+        if (execution != ExecutionMode::Parallel || count < PARALLEL_THRESHOLD) {
+            return 1;
+        }
+        return (count + chunkLength() - 1) / chunkLength();
+    }
+
+    // fn(chunk, begin, end) для частей диапазона [0, count): в режиме Parallel
+    // части выполняются пулом потоков, иначе весь диапазон - одна часть
+    template <typename Fn>
+    void forEachChunk(size_t count, Fn fn) const {
+        size_t chunks = chunkCount(count);
+        if (chunks == 1) {
+            fn(size_t(0), size_t(0), count);
+            return;
+        }
+        size_t length = chunkLength();
+        ThreadPool::instance().run(chunks, [&](size_t chunk) {
+            size_t begin = chunk * length;
+            fn(chunk, begin, std::min(count, begin + length));
+        });
+    }
+
+    MappedArrayHeader* mappedHeader() const {
+        return static_cast<MappedArrayHeader*>(mapping->data());
+    }
+
+    // Указатель на элементы и емкость по текущему отображению файла
+    void attachMapping() {
+        data = reinterpret_cast<T*>(mappedHeader() + 1);
+        capacity = (mapping->bytes() - sizeof(MappedArrayHeader)) / sizeof(T);
+    }
+
+    // Новый размер; у отображенного массива он сразу записывается в заголовок
+    void setSize(size_t newSize) {
+        size = newSize;
+        if (mapping) {
+            mappedHeader()->count = newSize;
+        }
+    }
+
+    void copyFrom(const T* source, size_t count) {
+        forEachChunk(count, [&](size_t, size_t begin, size_t end) {
+            std::copy(source + begin, source + end, data + begin);
+        });
+    }
+
+    static void checkValue(int value) {
+        if (value < -100 || value > 100) {
+            throw std::invalid_argument("Значение должно быть в диапазоне от -100 до 100");
+        }
+    }
+
+    // Проверка всего диапазона за один проход: ищутся минимум и максимум
+    template <typename Iterator>
+    static void checkValues(Iterator first, Iterator last) {
+        int minValue = 0;
+        int maxValue = 0;
+        for (Iterator it = first; it != last; ++it) {
+            int value = *it;
+            minValue = (value < minValue) ? value : minValue;
+            maxValue = (value > maxValue) ? value : maxValue;
+        }
+        checkValue(minValue);
+        checkValue(maxValue);
+    }
+
+    // Новая емкость не меньше required, при росте - как минимум вдвое больше текущей
+    size_t grownCapacity(size_t required) const {
+        size_t doubled = capacity * 2;
+        return (doubled > required) ? doubled : required;
+    }
+
+    // Переход в буфер емкости не меньше newCapacity; при newCapacity не больше
+    // встроенной емкости данные возвращаются во встроенный буфер.
+    // Отображенный файл меняет размер на месте
+    void reallocate(size_t newCapacity) {
+        if (mapping) {
+            // При ошибке остается прежнее отображение; указатель перечитывается в обоих случаях
+            try {
+                mapping->resize(sizeof(MappedArrayHeader) + newCapacity * sizeof(T));
+            } catch (...) {
+                attachMapping();
+                throw;
+            }
+            attachMapping();
+            return;
+        }
+        size_t bufferCapacity = 0;
+        T* newData = allocateBuffer(newCapacity, bufferCapacity);
+        if (newData != data) {
+            std::copy(data, data + size, newData);
+            releaseBuffer(data, capacity);
+            data = newData;
+            capacity = bufferCapacity;
+        }
+    }
+
+public:
+    BasicDynamicArray(size_t arraySize, ExecutionMode mode = ExecutionMode::Serial,
+                      const Allocator& alloc = Allocator())
+        : BasicDynamicArray(arraySize, Uninitialized(), mode, alloc) {
+        forEachChunk(size, [&](size_t, size_t begin, size_t end) {
+            std::fill(data + begin, data + end, T(0));
+        });
+    }
+
+    // Массив с памятью из alloc, например PmrDynamicArray(n, &threadArena())
+    BasicDynamicArray(size_t arraySize, const Allocator& alloc)
+        : BasicDynamicArray(arraySize, ExecutionMode::Serial, alloc) {}
+
+    // Копия наследует режим выполнения оригинала, распределитель выбирается
+    // по правилам стандартных контейнеров
+    BasicDynamicArray(const BasicDynamicArray& other)
+        : BasicDynamicArray(other.size, Uninitialized(), other.execution,
+                            AllocatorTraits::select_on_container_copy_construction(other.allocator)) {
+        copyFrom(other.data, size);
+    }
+
+    // Преобразование между типами хранения (значения уже проверены)
+    template <typename U, typename A>
+    explicit BasicDynamicArray(const BasicDynamicArray<U, A>& other, const Allocator& alloc = Allocator())
+        : BasicDynamicArray(other.size, Uninitialized(), other.execution, alloc) {
+        forEachChunk(size, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                data[i] = static_cast<T>(other.data[i]);
+            }
+        });
+    }
+
+    // Вычисление ленивого выражения (a + b - c ...) одним проходом
+    template <typename E, typename = typename std::enable_if<IsArrayOperation<E>::value>::type>
+    BasicDynamicArray(const E& expression, const Allocator& alloc = Allocator())
+        : BasicDynamicArray(expression.size(), Uninitialized(), ExecutionMode::Serial, alloc) {
+        evaluateExpression(expression, data);
+    }
+
+    BasicDynamicArray(BasicDynamicArray&& other) noexcept
+        : allocator(std::move(other.allocator)), data(inlineBuffer), size(0), capacity(INLINE_CAPACITY),
+          execution(other.execution) {
+        takeStorage(other);
+    }
+
+    ~BasicDynamicArray() {
+        if (mapping) {
+            mapping->close(sizeof(MappedArrayHeader) + size * sizeof(T));
+        } else {
+            releaseBuffer(data, capacity);
+        }
+    }
+
+    // Массив, хранящийся в файле: MappedArrayHeader и элементы (пустой файл
+    // создается при отсутствии). Файл не читается при открытии: страницы
+    // подгружаются при обращении, поэтому значения не проверяются - файл
+    // должен быть записан этим классом. Рост массива увеличивает файл,
+    // при уничтожении лишняя емкость отрезается
+    static BasicDynamicArray openMapped(const std::string& path, ExecutionMode mode = ExecutionMode::Serial) {
+        std::unique_ptr<MappedFile> file(new MappedFile(path));
+        if (file->bytes() == 0) {
+            file->resize(sizeof(MappedArrayHeader));
+            MappedArrayHeader* header = static_cast<MappedArrayHeader*>(file->data());
+            std::copy(MAPPED_ARRAY_MAGIC, MAPPED_ARRAY_MAGIC + 4, header->magic);
+            header->elementSize = sizeof(T);
+            header->count = 0;
+        }
+        const MappedArrayHeader* header = static_cast<const MappedArrayHeader*>(file->data());
+        if (file->bytes() < sizeof(MappedArrayHeader) ||
+            !std::equal(MAPPED_ARRAY_MAGIC, MAPPED_ARRAY_MAGIC + 4, header->magic) ||
+            header->elementSize != sizeof(T)) {
+            throw std::runtime_error("Неподдерживаемый формат файла " + path);
+        }
+        size_t fileCapacity = (file->bytes() - sizeof(MappedArrayHeader)) / sizeof(T);
+        if (header->count > fileCapacity) {
+            throw std::runtime_error("Файл поврежден: " + path);
+        }
+
+        BasicDynamicArray array(0, mode);
+        array.size = static_cast<size_t>(header->count);
+        array.mapping = std::move(file);
+        array.attachMapping();
+        return array;
+    }
+
+    bool isMapped() const {
+        return mapping != nullptr;
+    }
+
+    // Запись изменений отображенного массива на диск (msync).
+    // Для обычного массива ничего не делает
+    void sync() {
+        if (mapping) {
+            mapping->sync();
+        }
+    }
+
+    void print() const {
+        std::string text = "Массив [размер: " + std::to_string(size) + "]: ";
+        formatValues(data, size, ", ", text);
+        text += '\n';
+        std::cout.write(text.data(), text.size());
+        std::cout.flush();
+    }
+
+    // Замена содержимого числами из потока (через пробельные символы).
+    // Все значения проверяются до изменения массива
+    void loadText(std::istream& in) {
+        std::vector<int> values;
+        parseValues(readAll(in), values);
+        checkValues(values.begin(), values.end());
+        BasicDynamicArray loaded(values.size(), Uninitialized(), execution, allocator);
+        std::copy(values.begin(), values.end(), loaded.data);
+        *this = std::move(loaded);
+    }
+
+    // Значения через пробел одной записью, формат читается loadText
+    void dumpText(std::ostream& out) const {
+        std::string text;
+        formatValues(data, size, " ", text);
+        text += '\n';
+        out.write(text.data(), text.size());
+    }
+
+    // Двоичный формат - буфер как есть, без заголовка: int32 для DynamicArray,
+    // int8 для CompactDynamicArray, порядок байтов машины
+    void saveBinary(const std::string& path) const {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("Не удалось открыть файл " + path);
+        }
+        bool written = std::fwrite(data, sizeof(T), size, file) == size;
+        if (std::fclose(file) != 0 || !written) {
+            throw std::runtime_error("Ошибка записи в файл " + path);
+        }
+    }
+
+    void loadBinary(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            throw std::runtime_error("Не удалось открыть файл " + path);
+        }
+        long bytes = -1;
+        if (std::fseek(file, 0, SEEK_END) == 0) {
+            bytes = std::ftell(file);
+            std::rewind(file);
+        }
+        if (bytes < 0 || bytes % sizeof(T) != 0) {
+            std::fclose(file);
+            throw std::runtime_error("Некорректный размер файла " + path);
+        }
+        size_t count = static_cast<size_t>(bytes) / sizeof(T);
+        BasicDynamicArray loaded(count, Uninitialized(), execution, allocator);
+        bool read = std::fread(loaded.data, sizeof(T), count, file) == count;
+        std::fclose(file);
+        if (!read) {
+            throw std::runtime_error("Ошибка чтения файла " + path);
+        }
+        checkValues(loaded.data, loaded.data + count);
+        *this = std::move(loaded);
+    }
+
+    void setValue(size_t index, int value) {
+        if (index >= size) {
+            throw std::out_of_range("Индекс выходит за границы массива");
+        }
+        checkValue(value);
+        data[index] = static_cast<T>(value);
+    }
+
+    int getValue(size_t index) const {
+        if (index >= size) {
+            throw std::out_of_range("Индекс выходит за границы массива");
+        }
+        return data[index];
+    }
+
+    void pushBack(int value) {
+        checkValue(value);
+        if (size == capacity) {
+            reallocate(grownCapacity(size + 1));
+        }
+        data[size] = static_cast<T>(value);
+        setSize(size + 1);
+    }
+
+    // Добавление диапазона значений (прямые итераторы): проверка выполняется
+    // один раз для всего диапазона, память выделяется не более одного раза
+    template <typename Iterator>
+    void append(Iterator first, Iterator last) {
+        checkValues(first, last);
+        size_t count = static_cast<size_t>(std::distance(first, last));
+        if (size + count > capacity && mapping) {
+            // Отображение может переместиться при росте файла
+            std::vector<T> values(first, last);
+            reallocate(grownCapacity(size + count));
+            std::copy(values.begin(), values.end(), data + size);
+        } else if (size + count > capacity) {
+            // Диапазон может указывать на элементы этого массива, поэтому
+            // старый буфер освобождается только после копирования
+            size_t newCapacity = 0;
+            T* newData = allocateBuffer(grownCapacity(size + count), newCapacity);
+            std::copy(data, data + size, newData);
+            std::copy(first, last, newData + size);
+            releaseBuffer(data, capacity);
+            data = newData;
+            capacity = newCapacity;
+        } else {
+            std::copy(first, last, data + size);
+        }
+        setSize(size + count);
+    }
+
+    void append(const int* values, size_t count) {
+        append(values, values + count);
+    }
+
+    void append(const BasicDynamicArray& other) {
+        append(other.data, other.data + other.size);
+    }
+
+    // Новые элементы заполняются нулями; при уменьшении емкость сохраняется
+    void resize(size_t newSize) {
+        if (newSize > capacity) {
+            reallocate(grownCapacity(newSize));
+        }
+        if (newSize > size) {
+            std::fill(data + size, data + newSize, T(0));
+        }
+        setSize(newSize);
+    }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > capacity) {
+            reallocate(newCapacity);
+        }
+    }
+
+    void shrinkToFit() {
+        if (capacity > size) {
+            reallocate(size);
+        }
+    }
+
+    // Общая часть считается ядром из array_kernels.h, хвост более длинного
+    // массива копируется отдельно (у короткого там нули).
+    // Результат получает режим выполнения и распределитель этого массива
+    BasicDynamicArray add(const BasicDynamicArray& other) const {
+        size_t common = std::min(size, other.size);
+        BasicDynamicArray result(std::max(size, other.size), Uninitialized(), execution, allocator);
+        const T* longer = (size > common) ? data : other.data;
+        forEachChunk(result.size, [&](size_t, size_t begin, size_t end) {
+            size_t split = std::min(std::max(begin, common), end);
+            if (split > begin) {
+                addClamped(data + begin, other.data + begin, result.data + begin, split - begin);
+            }
+            if (end > split) {
+                std::copy(longer + split, longer + end, result.data + split);
+            }
+        });
+        return result;
+    }
+
+    BasicDynamicArray subtract(const BasicDynamicArray& other) const {
+        size_t common = std::min(size, other.size);
+        BasicDynamicArray result(std::max(size, other.size), Uninitialized(), execution, allocator);
+        forEachChunk(result.size, [&](size_t, size_t begin, size_t end) {
+            size_t split = std::min(std::max(begin, common), end);
+            if (split > begin) {
+                subtractClamped(data + begin, other.data + begin, result.data + begin, split - begin);
+            }
+            if (end > split && size > common) {
+                std::copy(data + split, data + end, result.data + split);
+            } else if (end > split) {
+                negateValues(other.data + split, result.data + split, end - split);
+            }
+        });
+        return result;
+    }
+
+    void fill(int value) {
+        checkValue(value);
+        forEachChunk(size, [&](size_t, size_t begin, size_t end) {
+            std::fill(data + begin, data + end, static_cast<T>(value));
+        });
+    }
+
+    // Свертки: частичные результаты частей объединяются по порядку,
+    // поэтому ответ не зависит от режима выполнения
+    long long sum() const {
+        std::vector<long long> partial(chunkCount(size), 0);
+        forEachChunk(size, [&](size_t chunk, size_t begin, size_t end) {
+            long long total = 0;
+            for (size_t i = begin; i < end; ++i) {
+                total += data[i];
+            }
+            partial[chunk] = total;
+        });
+        long long total = 0;
+        for (size_t i = 0; i < partial.size(); ++i) {
+            total += partial[i];
+        }
+        return total;
+    }
+
+    int minValue() const {
+        if (size == 0) {
+            throw std::out_of_range("Массив пуст");
+        }
+        std::vector<T> partial(chunkCount(size));
+        forEachChunk(size, [&](size_t chunk, size_t begin, size_t end) {
+            partial[chunk] = *std::min_element(data + begin, data + end);
+        });
+        return *std::min_element(partial.begin(), partial.end());
+    }
+
+    int maxValue() const {
+        if (size == 0) {
+            throw std::out_of_range("Массив пуст");
+        }
+        std::vector<T> partial(chunkCount(size));
+        forEachChunk(size, [&](size_t chunk, size_t begin, size_t end) {
+            partial[chunk] = *std::max_element(data + begin, data + end);
+        });
+        return *std::max_element(partial.begin(), partial.end());
+    }
+
+    // Количество элементов со значением от low до high включительно
+    size_t countInRange(int low, int high) const {
+        std::vector<size_t> partial(chunkCount(size), 0);
+        forEachChunk(size, [&](size_t chunk, size_t begin, size_t end) {
+            size_t count = 0;
+            for (size_t i = begin; i < end; ++i) {
+                int value = data[i];
+                count += (value >= low) & (value <= high);
+            }
+            partial[chunk] = count;
+        });
+        size_t count = 0;
+        for (size_t i = 0; i < partial.size(); ++i) {
+            count += partial[i];
+        }
+        return count;
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    const T* rawData() const {
+        return data;
+    }
+
+    ExecutionMode getExecutionMode() const {
+        return execution;
+    }
+
+    void setExecutionMode(ExecutionMode mode) {
+        execution = mode;
+    }
+
+    Allocator getAllocator() const {
+        return allocator;
+    }
+
+    // Распределитель и режим выполнения при присваивании (копированием
+    // и перемещением) не меняются, как у std::pmr-контейнеров
+    BasicDynamicArray& operator=(const BasicDynamicArray& other) {
+        if (this != &other) {
+            // Имеющийся буфер переиспользуется, если его хватает
+            if (other.size > capacity) {
+                setSize(0);
+                reallocate(other.size);
+            }
+            copyFrom(other.data, other.size);
+            setSize(other.size);
+        }
+        return *this;
+    }
+
+    // Буфер other забирается, только если его освободит распределитель этого
+    // массива. В отображенный массив значения копируются (файл сохраняется)
+    BasicDynamicArray& operator=(BasicDynamicArray&& other) {
+        if (this == &other) {
+            return *this;
+        }
+        if (!mapping && (other.mapping || allocator == other.allocator)) {
+            releaseBuffer(data, capacity);
+            takeStorage(other);
+        } else {
+            *this = static_cast<const BasicDynamicArray&>(other);
+        }
+        return *this;
+    }
+
+    // Выражение может ссылаться на этот же массив: при нехватке емкости
+    // старый буфер освобождается только после вычисления
+    template <typename E, typename = typename std::enable_if<IsArrayOperation<E>::value>::type>
+    BasicDynamicArray& operator=(const E& expression) {
+        size_t newSize = expression.size();
+        if (newSize > capacity && mapping) {
+            BasicDynamicArray evaluated(expression);
+            reallocate(newSize);
+            std::copy(evaluated.data, evaluated.data + newSize, data);
+        } else if (newSize > capacity) {
+            size_t newCapacity = 0;
+            T* newData = allocateBuffer(newSize, newCapacity);
+            evaluateExpression(expression, newData);
+            releaseBuffer(data, capacity);
+            data = newData;
+            capacity = newCapacity;
+        } else {
+            evaluateExpression(expression, data);
+        }
+        setSize(newSize);
+        return *this;
+    }
+};
+
+typedef BasicDynamicArray<int> DynamicArray;
+typedef BasicDynamicArray<int8_t> CompactDynamicArray;
+
+// Массив с памятью из std::pmr::memory_resource (арена, пул)
+typedef BasicDynamicArray<int, std::pmr::polymorphic_allocator<int> > PmrDynamicArray;
+
+// Монотонная арена текущего потока: выделение - сдвиг указателя, освобождение
+// отдельных буферов ничего не делает, вся память возвращается разом через
+// threadArena().release(), когда массивы из арены больше не используются
+inline std::pmr::monotonic_buffer_resource& threadArena() {
+    thread_local std::pmr::monotonic_buffer_resource arena(64 << 10);
+    return arena;
+}
+
+#endif
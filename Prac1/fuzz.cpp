@@ -0,0 +1,402 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "dynamic_array.h"
+
+using namespace std;
+
+// Случайная сравнительная проверка DynamicArray и CompactDynamicArray:
+// ленивые выражения и цепочки add/subtract сверяются с простой эталонной
+// реализацией на std::vector<int> (ограничение на каждом шаге, 0 за концом
+// более короткого массива), операции и свертки в режиме Parallel - с ней же
+// на длинах около PARALLEL_THRESHOLD и границ частей. Текстовый и двоичный
+// ввод-вывод проверяется записью и чтением обратно, массив в отображенном
+// файле - повторным открытием.
+// fuzz [rounds] [seed]
+
+typedef vector<int> Values;
+
+struct Fuzz {
+    mt19937_64 gen;
+    size_t checks;
+    size_t failures;
+    std::string path;  // временный файл для двоичного формата и отображения
+
+    size_t randomSize(size_t maxSize) {
+        // Часто пустые и совпадающие длины, иначе произвольные
+        switch (gen() % 4) {
+            case 0: return 0;
+            case 1: return 64;
+            default: return gen() % (maxSize + 1);
+        }
+    }
+
+    Values randomValues(size_t count) {
+        Values values(count);
+        for (size_t i = 0; i < count; ++i) {
+            // Значения у границ диапазона выходят за +/-100 после сложения
+            values[i] = (gen() % 2) ? static_cast<int>(gen() % 201) - 100 : ((gen() % 2) ? 100 : -100);
+        }
+        return values;
+    }
+
+    static Values combine(const Values& a, const Values& b, bool subtract) {
+        Values result(max(a.size(), b.size()));
+        for (size_t i = 0; i < result.size(); ++i) {
+            int x = (i < a.size()) ? a[i] : 0;
+            int y = (i < b.size()) ? b[i] : 0;
+            result[i] = clampValue(subtract ? x - y : x + y);
+        }
+        return result;
+    }
+
+    template <typename T>
+    static BasicDynamicArray<T> makeArray(const Values& values) {
+        BasicDynamicArray<T> array(0);
+        array.append(values.begin(), values.end());
+        return array;
+    }
+
+    template <typename T>
+    void expect(const char* name, const BasicDynamicArray<T>& actual, const Values& expected) {
+        ++checks;
+        bool same = actual.getSize() == expected.size();
+        size_t i = 0;
+        for (; same && i < expected.size(); ++i) {
+            same = actual.getValue(i) == expected[i];
+        }
+        if (!same && ++failures <= 20) {
+            printf("MISMATCH %s (%s): size %zu, expected %zu", name,
+                   sizeof(T) == 1 ? "int8_t" : "int", actual.getSize(), expected.size());
+            if (actual.getSize() == expected.size()) {
+                printf(", index %zu: %d instead of %d", i - 1, actual.getValue(i - 1), expected[i - 1]);
+            }
+            printf("\n");
+        }
+    }
+
+    void expectValue(const char* name, long long actual, long long expected) {
+        ++checks;
+        if (actual != expected && ++failures <= 20) {
+            printf("MISMATCH %s: %lld instead of %lld\n", name, actual, expected);
+        }
+    }
+
+    // Длина у порога параллельного режима, у границы части или случайная
+    template <typename T>
+    size_t parallelSize() {
+        size_t chunk = PARALLEL_CHUNK_BYTES / sizeof(T);
+        size_t delta = gen() % 3;
+        switch (gen() % 4) {
+            case 0: return PARALLEL_THRESHOLD + delta - 1;
+            case 1: return (1 + gen() % 3) * chunk + delta - 1;
+            case 2: return gen() % PARALLEL_THRESHOLD;
+            default: return gen() % (3 * chunk);
+        }
+    }
+
+    // Результаты в режиме Parallel совпадают с последовательными и эталонными
+    template <typename T>
+    void checkParallel() {
+        Values va = randomValues(parallelSize<T>());
+        Values vb = randomValues(parallelSize<T>());
+        BasicDynamicArray<T> a = makeArray<T>(va);
+        BasicDynamicArray<T> b = makeArray<T>(vb);
+        BasicDynamicArray<T> pa(a);
+        BasicDynamicArray<T> pb(b);
+        pa.setExecutionMode(ExecutionMode::Parallel);
+        pb.setExecutionMode(ExecutionMode::Parallel);
+
+        expect("parallel add", pa.add(pb), combine(va, vb, false));
+        expect("parallel add (shorter first)", pb.add(pa), combine(vb, va, false));
+        expect("parallel subtract", pa.subtract(pb), combine(va, vb, true));
+        expect("parallel subtract (tail negated)", pb.subtract(pa), combine(vb, va, true));
+        expect("parallel copy", BasicDynamicArray<T>(pa), va);
+        expect("parallel zero fill", BasicDynamicArray<T>(va.size(), ExecutionMode::Parallel), Values(va.size(), 0));
+
+        BasicDynamicArray<T> assigned(0, ExecutionMode::Parallel);
+        assigned = pb;
+        expect("parallel assign", assigned, vb);
+        // Присваивание копированием и перемещением сохраняет режим приемника
+        BasicDynamicArray<T> serial(0);
+        serial = pb;
+        expectValue("copy assign keeps mode", serial.getExecutionMode() == ExecutionMode::Serial, 1);
+        serial = BasicDynamicArray<T>(pa);
+        expect("move assign", serial, va);
+        expectValue("move assign keeps mode", serial.getExecutionMode() == ExecutionMode::Serial, 1);
+        assigned = BasicDynamicArray<T>(a);
+        expectValue("move assign keeps parallel mode", assigned.getExecutionMode() == ExecutionMode::Parallel, 1);
+        BasicDynamicArray<int> widened(pa);
+        expect("parallel int8/int conversion", widened, va);
+
+        long long sum = 0;
+        int minimum = 100;
+        int maximum = -100;
+        size_t inRange = 0;
+        int low = static_cast<int>(gen() % 201) - 100;
+        int high = low + static_cast<int>(gen() % 50);
+        for (size_t i = 0; i < va.size(); ++i) {
+            sum += va[i];
+            minimum = min(minimum, va[i]);
+            maximum = max(maximum, va[i]);
+            inRange += (va[i] >= low && va[i] <= high) ? 1 : 0;
+        }
+        expectValue("parallel sum", pa.sum(), sum);
+        expectValue("serial sum", a.sum(), sum);
+        expectValue("parallel countInRange", pa.countInRange(low, high), inRange);
+        if (!va.empty()) {
+            expectValue("parallel minValue", pa.minValue(), minimum);
+            expectValue("parallel maxValue", pa.maxValue(), maximum);
+        }
+
+        int value = static_cast<int>(gen() % 201) - 100;
+        pa.fill(value);
+        expect("parallel fill", pa, Values(va.size(), value));
+    }
+
+    // Ошибочные данные: исключение, содержимое массива не меняется
+    template <typename T, typename Fn>
+    void expectRejected(const char* name, BasicDynamicArray<T>& array, const Values& before, Fn load) {
+        bool thrown = false;
+        try {
+            load();
+        } catch (const exception&) {
+            thrown = true;
+        }
+        expectValue(name, thrown, 1);
+        expect(name, array, before);
+    }
+
+    void writeFile(const void* bytes, size_t count) {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file) {
+            fwrite(bytes, 1, count, file);
+            fclose(file);
+        }
+    }
+
+    // dumpText/loadText и saveBinary/loadBinary возвращают те же значения;
+    // загрузка заменяет прежнее содержимое
+    template <typename T>
+    void checkTextAndBinary(size_t maxSize) {
+        Values va = randomValues(randomSize(maxSize));
+        Values old = randomValues(gen() % 100);
+        BasicDynamicArray<T> a = makeArray<T>(va);
+
+        ostringstream text;
+        a.dumpText(text);
+        BasicDynamicArray<T> loaded = makeArray<T>(old);
+        istringstream in(text.str());
+        loaded.loadText(in);
+        expect("dumpText/loadText", loaded, va);
+        BasicDynamicArray<int> widened = makeArray<int>(old);
+        istringstream widenedIn(text.str());
+        widened.loadText(widenedIn);
+        expect("dumpText/loadText into DynamicArray", widened, va);
+
+        // Произвольные пробельные символы между числами и по краям
+        const char* blanks[] = {" ", "\n", "\t", "\r\n", "  "};
+        string spaced = blanks[gen() % 5];
+        for (size_t i = 0; i < va.size(); ++i) {
+            spaced += to_string(va[i]) + blanks[gen() % 5];
+        }
+        istringstream spacedIn(spaced);
+        loaded.loadText(spacedIn);
+        expect("loadText with mixed whitespace", loaded, va);
+
+        // Значение вне диапазона или не число в случайном месте
+        string broken = text.str();
+        const char* bad[] = {" 101 ", " -101 ", " 2147483648 ", " 1x ", " - "};
+        broken.insert(broken.empty() ? 0 : gen() % broken.size(), bad[gen() % 5]);
+        broken.insert(0, " ");
+        istringstream brokenIn(broken);
+        expectRejected("loadText rejects bad value", loaded, va, [&]() { loaded.loadText(brokenIn); });
+
+        a.saveBinary(path);
+        error_code error;
+        expectValue("saveBinary file size", static_cast<long long>(filesystem::file_size(path, error)),
+                    static_cast<long long>(va.size() * sizeof(T)));
+        loaded = makeArray<T>(old);
+        loaded.loadBinary(path);
+        expect("saveBinary/loadBinary", loaded, va);
+
+        // Неполный элемент и значение вне диапазона в двоичном файле
+        vector<T> raw(va.begin(), va.end());
+        raw.push_back(static_cast<T>(sizeof(T) == 1 ? 127 : 1000));
+        swap(raw.back(), raw[gen() % raw.size()]);
+        writeFile(raw.data(), raw.size() * sizeof(T));
+        expectRejected("loadBinary rejects bad value", loaded, va, [&]() { loaded.loadBinary(path); });
+        if (sizeof(T) > 1) {
+            writeFile(raw.data(), raw.size() * sizeof(T) - 1);
+            expectRejected("loadBinary rejects partial element", loaded, va, [&]() { loaded.loadBinary(path); });
+        }
+    }
+
+    // Отображенный массив растет через несколько удвоений (pushBack, append, resize).
+    // Открытый повторно без sync() и без закрытия, а затем после закрытия,
+    // он содержит те же элементы: лишняя емкость файла не читается как данные
+    template <typename T>
+    void checkMapped() {
+        error_code error;
+        filesystem::remove(path, error);
+        Values expected;
+        {
+            BasicDynamicArray<T> mapped = BasicDynamicArray<T>::openMapped(path);
+            for (int step = 0; step < 12; ++step) {
+                switch (gen() % 3) {
+                    case 0:
+                        for (size_t count = gen() % 300; count > 0; --count) {
+                            int value = static_cast<int>(gen() % 201) - 100;
+                            mapped.pushBack(value);
+                            expected.push_back(value);
+                        }
+                        break;
+                    case 1: {
+                        Values more = randomValues(gen() % 700);
+                        mapped.append(more.begin(), more.end());
+                        expected.insert(expected.end(), more.begin(), more.end());
+                        break;
+                    }
+                    default: {
+                        size_t newSize = gen() % (2 * expected.size() + 100);
+                        mapped.resize(newSize);
+                        expected.resize(newSize, 0);
+                        break;
+                    }
+                }
+            }
+            expect("mapped growth", mapped, expected);
+            expectValue("mapped array is mapped", mapped.isMapped(), 1);
+#ifndef _WIN32
+            // Без mmap (Windows) изменения попадают в файл только в sync() и при закрытии
+            BasicDynamicArray<T> reopened = BasicDynamicArray<T>::openMapped(path);
+            expect("mapped reopen without sync", reopened, expected);
+#endif
+        }
+        expectValue("mapped file size after close", static_cast<long long>(filesystem::file_size(path, error)),
+                    static_cast<long long>(sizeof(MappedArrayHeader) + expected.size() * sizeof(T)));
+        BasicDynamicArray<T> closed = BasicDynamicArray<T>::openMapped(path);
+        expect("mapped reopen after close", closed, expected);
+
+        // Файл с другим размером элемента не открывается
+        if (sizeof(T) != sizeof(int)) {
+            bool thrown = false;
+            try {
+                BasicDynamicArray<int>::openMapped(path);
+            } catch (const exception&) {
+                thrown = true;
+            }
+            expectValue("mapped element size check", thrown, 1);
+        }
+    }
+
+    // Отображенный файл не проверяется при открытии, поэтому в нем бывают
+    // любые значения T: dumpText выводит их все, включая крайние
+    template <typename T>
+    void checkMappedDump() {
+        Values values(gen() % 200);
+        for (size_t i = 0; i < values.size(); ++i) {
+            switch (gen() % 3) {
+                case 0: values[i] = numeric_limits<T>::min(); break;
+                case 1: values[i] = numeric_limits<T>::max(); break;
+                default: values[i] = static_cast<T>(gen()); break;
+            }
+        }
+        MappedArrayHeader header;
+        copy(MAPPED_ARRAY_MAGIC, MAPPED_ARRAY_MAGIC + 4, header.magic);
+        header.elementSize = sizeof(T);
+        header.count = values.size();
+        vector<T> stored(values.begin(), values.end());
+        string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+        bytes.append(reinterpret_cast<const char*>(stored.data()), stored.size() * sizeof(T));
+        writeFile(bytes.data(), bytes.size());
+
+        BasicDynamicArray<T> mapped = BasicDynamicArray<T>::openMapped(path);
+        expect("mapped out-of-range values", mapped, values);
+        ostringstream text;
+        mapped.dumpText(text);
+        istringstream in(text.str());
+        Values printed;
+        int value = 0;
+        while (in >> value) {
+            printed.push_back(value);
+        }
+        expectValue("dumpText of out-of-range values", printed == values, 1);
+    }
+
+    // Выражения и цепочки add/subtract на массивах разной длины
+    template <typename T>
+    void checkExpressions(size_t maxSize) {
+        Values va = randomValues(randomSize(maxSize));
+        Values vb = randomValues(randomSize(maxSize));
+        Values vc = randomValues(randomSize(maxSize));
+        Values vd = randomValues(randomSize(maxSize));
+        BasicDynamicArray<T> a = makeArray<T>(va);
+        BasicDynamicArray<T> b = makeArray<T>(vb);
+        BasicDynamicArray<T> c = makeArray<T>(vc);
+        BasicDynamicArray<T> d = makeArray<T>(vd);
+
+        Values ab = combine(va, vb, false);
+        Values abc = combine(combine(va, vb, true), vc, false);
+        Values abcd = combine(combine(combine(va, vb, false), vc, true), vd, false);
+        Values grouped = combine(combine(va, vb, true), combine(vc, vd, false), true);
+
+        expect("add", a.add(b), ab);
+        expect("a + b", BasicDynamicArray<T>(a + b), ab);
+        expect("subtract/add", a.subtract(b).add(c), abc);
+        expect("a - b + c", BasicDynamicArray<T>(a - b + c), abc);
+        expect("add/subtract/add", a.add(b).subtract(c).add(d), abcd);
+        expect("a + b - c + d", BasicDynamicArray<T>(a + b - c + d), abcd);
+        expect("(a - b) - (c + d)", BasicDynamicArray<T>((a - b) - (c + d)), grouped);
+
+        // Присваивание выражения, ссылающегося на сам массив
+        BasicDynamicArray<T> target = a;
+        target = target - b + c;
+        expect("x = x - b + c", target, abc);
+        BasicDynamicArray<T> small = makeArray<T>(va);
+        small.shrinkToFit();
+        small = b + small + d;
+        expect("x = b + x + d", small, combine(combine(vb, va, false), vd, false));
+    }
+};
+
+int main(int argc, char* argv[]) {
+    size_t rounds = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 200;
+    unsigned long long seed = (argc > 2) ? strtoull(argv[2], nullptr, 10) : 1;
+
+    Fuzz fuzz;
+    fuzz.gen.seed(seed);
+    fuzz.checks = 0;
+    fuzz.failures = 0;
+    fuzz.path = (filesystem::temp_directory_path() / ("dynamic_array_fuzz_" + to_string(seed))).string();
+
+    for (size_t round = 0; round < rounds; ++round) {
+        // Короткие массивы (встроенный буфер, хвосты SIMD-ядер) и длинные
+        size_t maxSize = (round % 2) ? 80 : 3000;
+        fuzz.checkExpressions<int>(maxSize);
+        fuzz.checkExpressions<int8_t>(maxSize);
+        fuzz.checkTextAndBinary<int>(maxSize);
+        fuzz.checkTextAndBinary<int8_t>(maxSize);
+        if (round % 5 == 0) {
+            fuzz.checkMapped<int>();
+            fuzz.checkMapped<int8_t>();
+            fuzz.checkMappedDump<int>();
+            fuzz.checkMappedDump<int8_t>();
+        }
+        if (round % 10 == 0) {
+            fuzz.checkParallel<int>();
+            fuzz.checkParallel<int8_t>();
+        }
+    }
+
+    error_code error;
+    filesystem::remove(fuzz.path, error);
+
+    printf("%zu checks, %zu mismatches\n", fuzz.checks, fuzz.failures);
+    return (fuzz.failures == 0) ? 0 : 1;
+}
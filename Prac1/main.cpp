@@ -1,140 +1,5 @@
 #include <iostream>
-#include <stdexcept>
-
-class DynamicArray {
-private:
-    int* data;
-    size_t size;
-
-public:
-    DynamicArray(size_t arraySize) : size(arraySize) {
-        if (size > 0) {
-            data = new int[size];
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = 0;
-            }
-        } else {
-            data = nullptr;
-        }
-    }
-
-    DynamicArray(const DynamicArray& other) : size(other.size) {
-        if (size > 0) {
-            data = new int[size];
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = other.data[i];
-            }
-        } else {
-            data = nullptr;
-        }
-    }
-
-    ~DynamicArray() {
-        delete[] data;
-    }
-
-    void print() const {
-        std::cout << "Массив [размер: " << size << "]: ";
-        for (size_t i = 0; i < size; ++i) {
-            std::cout << data[i];
-            if (i < size - 1) {
-                std::cout << ", ";
-            }
-        }
-        std::cout << std::endl;
-    }
-
-    void setValue(size_t index, int value) {
-        if (index >= size) {
-            throw std::out_of_range("Индекс выходит за границы массива");
-        }
-        if (value < -100 || value > 100) {
-            throw std::invalid_argument("Значение должно быть в диапазоне от -100 до 100");
-        }
-        data[index] = value;
-    }
-    int getValue(size_t index) const {
-        if (index >= size) {
-            throw std::out_of_range("Индекс выходит за границы массива");
-        }
-        return data[index];
-    }
-
-    void pushBack(int value) {
-        if (value < -100 || value > 100) {
-            throw std::invalid_argument("Значение должно быть в диапазоне от -100 до 100");
-        }
-
-        size_t newSize = size + 1;
-        int* newData = new int[newSize];
-
-        for (size_t i = 0; i < size; ++i) {
-            newData[i] = data[i];
-        }
-
-        newData[size] = value;
-        delete[] data;
-        data = newData;
-        size = newSize;
-    }
-
-    DynamicArray add(const DynamicArray& other) const {
-        size_t maxSize = (size > other.size) ? size : other.size;
-        DynamicArray result(maxSize);
-
-        for (size_t i = 0; i < maxSize; ++i) {
-            int value1 = (i < size) ? data[i] : 0;
-            int value2 = (i < other.size) ? other.data[i] : 0;
-            int sum = value1 + value2;
-            
-            if (sum < -100) sum = -100;
-            if (sum > 100) sum = 100;
-            
-            result.data[i] = sum;
-        }
-
-        return result;
-    }
-
-    DynamicArray subtract(const DynamicArray& other) const {
-        size_t maxSize = (size > other.size) ? size : other.size;
-        DynamicArray result(maxSize);
-
-        for (size_t i = 0; i < maxSize; ++i) {
-            int value1 = (i < size) ? data[i] : 0;
-            int value2 = (i < other.size) ? other.data[i] : 0;
-            int diff = value1 - value2;
-            
-            if (diff < -100) diff = -100;
-            if (diff > 100) diff = 100;
-            
-            result.data[i] = diff;
-        }
-
-        return result;
-    }
-
-
-    size_t getSize() const {
-        return size;
-    }
-
-    DynamicArray& operator=(const DynamicArray& other) {
-        if (this != &other) {
-            delete[] data;
-            size = other.size;
-            if (size > 0) {
-                data = new int[size];
-                for (size_t i = 0; i < size; ++i) {
-                    data[i] = other.data[i];
-                }
-            } else {
-                data = nullptr;
-            }
-        }
-        return *this;
-    }
-};
+#include "dynamic_array.h"
 
 int main() {
     try {
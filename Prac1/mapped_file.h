@@ -0,0 +1,174 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <cstdio>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Файл, отображенный в память для чтения и записи (MAP_SHARED): страницы
+// подгружаются при первом обращении, изменения попадают в файл.
+// Без mmap (Windows) файл читается целиком и записывается в sync() и close()
+class MappedFile {
+public:
+    // Открывает файл, создавая пустой при отсутствии
+    explicit MappedFile(const std::string& filename)
+        : path(filename), descriptor(-1), address(nullptr), length(0) {
+#ifdef _WIN32
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file) {
+            char block[1 << 16];
+            size_t count = 0;
+            while ((count = std::fread(block, 1, sizeof(block), file)) > 0) {
+                fallback.insert(fallback.end(), block, block + count);
+            }
+            std::fclose(file);
+        }
+        descriptor = 0;
+        address = fallback.empty() ? nullptr : fallback.data();
+        length = fallback.size();
+#else
+        descriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (descriptor < 0) {
+            throw std::runtime_error("Не удалось открыть файл " + path);
+        }
+        struct stat info;
+        if (fstat(descriptor, &info) != 0) {
+            ::close(descriptor);
+            throw std::runtime_error("Не удалось получить размер файла " + path);
+        }
+        try {
+            map(static_cast<size_t>(info.st_size));
+        } catch (...) {
+            ::close(descriptor);
+            throw;
+        }
+#endif
+    }
+
+    ~MappedFile() {
+        close(length);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void* data() const {
+        return address;
+    }
+
+    size_t bytes() const {
+        return length;
+    }
+
+    // Новый размер файла; содержимое сохраняется, адрес может измениться.
+    // Прежнее отображение снимается только после создания нового, поэтому
+    // при исключении data() и bytes() остаются прежними
+    void resize(size_t newLength) {
+        if (newLength == length) return;
+#ifdef _WIN32
+        fallback.resize(newLength);
+        address = fallback.empty() ? nullptr : fallback.data();
+        length = newLength;
+#else
+        size_t oldLength = length;
+        if (newLength > oldLength && ftruncate(descriptor, static_cast<off_t>(newLength)) != 0) {
+            throw std::runtime_error("Не удалось изменить размер файла " + path);
+        }
+        void* mapped = nullptr;
+        if (newLength > 0) {
+            mapped = mmap(nullptr, newLength, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+            if (mapped == MAP_FAILED) {
+                if (newLength > oldLength && ftruncate(descriptor, static_cast<off_t>(oldLength)) != 0) {
+                    // Файл остается увеличенным, прежнее отображение действительно
+                }
+                throw std::runtime_error("Не удалось отобразить файл " + path);
+            }
+        }
+        unmap();
+        address = mapped;
+        length = newLength;
+        if (newLength < oldLength && ftruncate(descriptor, static_cast<off_t>(newLength)) != 0) {
+            // Файл остается прежнего размера, лишний хвост не отображается
+        }
+#endif
+    }
+
+    void sync() {
+#ifdef _WIN32
+        if (!writeFallback(length)) {
+            throw std::runtime_error("Ошибка записи в файл " + path);
+        }
+#else
+        if (address != nullptr && msync(address, length, MS_SYNC) != 0) {
+            throw std::runtime_error("Ошибка записи в файл " + path);
+        }
+#endif
+    }
+
+    // Закрытие с обрезкой файла до finalLength байт (лишняя емкость не сохраняется)
+    void close(size_t finalLength) noexcept {
+        if (descriptor < 0) return;
+#ifdef _WIN32
+        writeFallback(finalLength);
+        fallback.clear();
+#else
+        unmap();
+        if (ftruncate(descriptor, static_cast<off_t>(finalLength)) != 0) {
+            // Файл остается прежнего размера, данные в нем уже записаны
+        }
+        ::close(descriptor);
+#endif
+        descriptor = -1;
+        address = nullptr;
+        length = 0;
+    }
+
+private:
+#ifdef _WIN32
+    bool writeFallback(size_t count) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        bool written = std::fwrite(fallback.data(), 1, count, file) == count;
+        return std::fclose(file) == 0 && written;
+    }
+#else
+    void map(size_t newLength) {
+        address = nullptr;
+        length = newLength;
+        if (newLength == 0) return;
+        void* mapped = mmap(nullptr, newLength, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        if (mapped == MAP_FAILED) {
+            length = 0;
+            throw std::runtime_error("Не удалось отобразить файл " + path);
+        }
+        address = mapped;
+    }
+
+    void unmap() {
+        if (address != nullptr) {
+            munmap(address, length);
+        }
+        address = nullptr;
+    }
+#endif
+
+    std::string path;
+    int descriptor;
+    void* address;
+    size_t length;
+#ifdef _WIN32
+    std::vector<char> fallback;
+#endif
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Постоянный пул потоков для поэлементных операций над большими массивами.
+// run() раздает номера частей работы потокам пула и вызывающему потоку
+// и возвращается, когда выполнены все части. Задачи выполняются по одной;
+// вызывать run() изнутри задачи нельзя
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads)
+        : task(nullptr), chunkCount(0), nextChunk(0), busyWorkers(0), generation(0), stopping(false) {
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Общий пул: по одному потоку на ядро, считая вызывающий
+    static ThreadPool& instance() {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    size_t threadCount() const {
+        return workers.size() + 1;
+    }
+
+    void run(size_t chunks, const std::function<void(size_t)>& chunkTask) {
+        if (workers.empty() || chunks <= 1) {
+            for (size_t i = 0; i < chunks; ++i) {
+                chunkTask(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(runMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &chunkTask;
+            chunkCount = chunks;
+            nextChunk = 0;
+            busyWorkers = workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return busyWorkers == 0; });
+        task = nullptr;
+    }
+
+private:
+    void work() {
+        for (;;) {
+            size_t chunk = nextChunk.fetch_add(1);
+            if (chunk >= chunkCount) break;
+            (*task)(chunk);
+        }
+    }
+
+    void workerLoop() {
+        size_t seen = 0;
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            lock.unlock();
+
+            work();
+
+            lock.lock();
+            if (--busyWorkers == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)>* task;
+    size_t chunkCount;
+    std::atomic<size_t> nextChunk;
+    size_t busyWorkers;
+    size_t generation;
+    bool stopping;
+};
+
+#endif
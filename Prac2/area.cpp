@@ -0,0 +1,533 @@
+#include "area.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace std;
+
+// Минимальное число фигур (или полос) на один поток
+const size_t AREA_SHAPES_PER_WORKER = 64;
+
+// Размер блока выборки Монте-Карло, у каждого блока свой генератор
+const size_t MONTE_CARLO_BLOCK = 1 << 16;
+
+typedef pair<double, double> Interval;
+
+// ---------- Заметание для квадратов ----------
+
+struct SweepEvent {
+    double x;
+    double bottom;
+    double top;
+    int delta;
+};
+
+static bool eventLess(const SweepEvent& a, const SweepEvent& b) {
+    return a.x < b.x;
+}
+
+// Дерево отрезков: сколько раз покрыт каждый элементарный отрезок по y
+class CoverageTree {
+public:
+    explicit CoverageTree(const vector<double>& ys)
+        : ys(ys), segments(ys.size() - 1), count(4 * segments, 0), covered(4 * segments, 0.0) {}
+
+    void update(size_t lo, size_t hi, int delta) {
+        update(1, 0, segments, lo, hi, delta);
+    }
+
+    double coveredLength() const {
+        return covered[1];
+    }
+
+private:
+    void update(size_t node, size_t l, size_t r, size_t lo, size_t hi, int delta) {
+        if (hi <= l || r <= lo) return;
+        if (lo <= l && r <= hi) {
+            count[node] += delta;
+        } else {
+            size_t m = (l + r) / 2;
+            update(2 * node, l, m, lo, hi, delta);
+            update(2 * node + 1, m, r, lo, hi, delta);
+        }
+        if (count[node] > 0) {
+            covered[node] = ys[r] - ys[l];
+        } else if (r - l == 1) {
+            covered[node] = 0.0;
+        } else {
+            covered[node] = covered[2 * node] + covered[2 * node + 1];
+        }
+    }
+
+    const vector<double>& ys;
+    size_t segments;
+    vector<int> count;
+    vector<double> covered;
+};
+
+// Площадь объединения квадратов внутри вертикальной полосы [xa, xb]
+static double sweepStrip(const vector<Square>& squares, double xa, double xb) {
+    vector<SweepEvent> events;
+    vector<double> ys;
+    for (size_t i = 0; i < squares.size(); ++i) {
+        const Square& s = squares[i];
+        if (!(s.side > 0)) continue;
+        double left = max(s.topLeft.x, xa);
+        double right = min(s.topLeft.x + s.side, xb);
+        if (left >= right) continue;
+        double top = s.topLeft.y;
+        double bottom = s.topLeft.y - s.side;
+        events.push_back(SweepEvent{left, bottom, top, 1});
+        events.push_back(SweepEvent{right, bottom, top, -1});
+        ys.push_back(bottom);
+        ys.push_back(top);
+    }
+    if (events.empty()) return 0.0;
+
+    sort(ys.begin(), ys.end());
+    ys.erase(unique(ys.begin(), ys.end()), ys.end());
+    sort(events.begin(), events.end(), eventLess);
+
+    CoverageTree tree(ys);
+    double area = 0.0;
+    double prevX = events[0].x;
+    for (size_t i = 0; i < events.size(); ++i) {
+        const SweepEvent& e = events[i];
+        area += tree.coveredLength() * (e.x - prevX);
+        prevX = e.x;
+        size_t lo = lower_bound(ys.begin(), ys.end(), e.bottom) - ys.begin();
+        size_t hi = lower_bound(ys.begin(), ys.end(), e.top) - ys.begin();
+        tree.update(lo, hi, e.delta);
+    }
+    return area;
+}
+
+double squaresUnionArea(const vector<Square>& squares) {
+    vector<double> xs;
+    xs.reserve(2 * squares.size());
+    for (size_t i = 0; i < squares.size(); ++i) {
+        if (!(squares[i].side > 0)) continue;
+        xs.push_back(squares[i].topLeft.x);
+        xs.push_back(squares[i].topLeft.x + squares[i].side);
+    }
+    if (xs.empty()) return 0.0;
+    sort(xs.begin(), xs.end());
+    xs.erase(unique(xs.begin(), xs.end()), xs.end());
+    if (xs.size() < 2) return 0.0;
+
+    // Границы полос выбираются по координатам событий, чтобы работа делилась поровну
+    size_t gaps = xs.size() - 1;
+    size_t parts = workerCount(squares.size(), AREA_SHAPES_PER_WORKER);
+    if (parts > gaps) parts = gaps;
+    vector<double> partial(parts, 0.0);
+    parallelFor(parts, [&](size_t part) {
+        double xa = xs[chunkBegin(gaps, parts, part)];
+        double xb = xs[chunkBegin(gaps, parts, part + 1)];
+        partial[part] = sweepStrip(squares, xa, xb);
+    });
+
+    double area = 0.0;
+    for (size_t part = 0; part < parts; ++part) {
+        area += partial[part];
+    }
+    return area;
+}
+
+// ---------- Формула Грина для кругов и квадратов ----------
+
+// Ограничивающий прямоугольник фигуры для отбора соседей
+struct ShapeBox {
+    double minX, maxX, minY, maxY;
+    bool isCircle;
+    size_t index;
+};
+
+static ShapeBox circleBox(const Circle& c, size_t index) {
+    return ShapeBox{c.center.x - c.radius, c.center.x + c.radius,
+                    c.center.y - c.radius, c.center.y + c.radius, true, index};
+}
+
+static ShapeBox squareBox(const Square& s, size_t index) {
+    return ShapeBox{s.topLeft.x, s.topLeft.x + s.side,
+                    s.topLeft.y - s.side, s.topLeft.y, false, index};
+}
+
+// Наибольшее число клеток сетки по одной оси
+const size_t MAX_GRID_CELLS = 1024;
+
+// Равномерная сетка над ограничивающими прямоугольниками: каждая фигура
+// записана во все клетки, которые пересекает ее прямоугольник.
+// Клетка - порядка среднего размера фигуры, поэтому фигура занимает немного
+// клеток и в клетке немного фигур; всего клеток не больше 4 на фигуру
+class BoxGrid {
+public:
+    explicit BoxGrid(const vector<ShapeBox>& boxes)
+        : minX(boxes[0].minX), maxX(boxes[0].maxX), minY(boxes[0].minY), maxY(boxes[0].maxY) {
+        double meanW = 0.0, meanH = 0.0;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            minX = min(minX, boxes[i].minX);
+            maxX = max(maxX, boxes[i].maxX);
+            minY = min(minY, boxes[i].minY);
+            maxY = max(maxY, boxes[i].maxY);
+            meanW += (boxes[i].maxX - boxes[i].minX) / boxes.size();
+            meanH += (boxes[i].maxY - boxes[i].minY) / boxes.size();
+        }
+        double spanX = maxX - minX;
+        double spanY = maxY - minY;
+        cellW = max(meanW, spanX / MAX_GRID_CELLS);
+        cellH = max(meanH, spanY / MAX_GRID_CELLS);
+        double cellCount = (spanX / cellW + 1) * (spanY / cellH + 1);
+        double maxCells = 4.0 * boxes.size();
+        if (cellCount > maxCells) {
+            double scale = sqrt(cellCount / maxCells);
+            cellW *= scale;
+            cellH *= scale;
+        }
+        gridX = min(MAX_GRID_CELLS, static_cast<size_t>(spanX / cellW) + 1);
+        gridY = min(MAX_GRID_CELLS, static_cast<size_t>(spanY / cellH) + 1);
+        cells.resize(gridX * gridY);
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            const ShapeBox& b = boxes[i];
+            size_t x0 = cellX(b.minX);
+            size_t y0 = cellY(b.minY);
+            for (size_t y = y0; y <= cellY(b.maxY); ++y) {
+                for (size_t x = x0; x <= cellX(b.maxX); ++x) {
+                    cells[y * gridX + x].push_back(GridEntry{b, x0, y0});
+                }
+            }
+        }
+    }
+
+    // Фигура в клетке и первая клетка, которую она занимает
+    struct GridEntry {
+        ShapeBox box;
+        size_t firstX, firstY;
+    };
+
+    size_t cellX(double x) const {
+        return min(gridX - 1, static_cast<size_t>(max(0.0, x - minX) / cellW));
+    }
+
+    size_t cellY(double y) const {
+        return min(gridY - 1, static_cast<size_t>(max(0.0, y - minY) / cellH));
+    }
+
+    const vector<GridEntry>& cell(size_t x, size_t y) const {
+        return cells[y * gridX + x];
+    }
+
+    double minX, maxX, minY, maxY;
+
+private:
+    size_t gridX, gridY;
+    double cellW, cellH;
+    vector<vector<GridEntry> > cells;
+};
+
+// Фигуры, ограничивающие прямоугольники которых пересекаются с box.
+// Пара может встретиться в нескольких клетках, поэтому учитывается только
+// клетка, с которой начинается пересечение прямоугольников
+static void findNeighbours(const BoxGrid& grid, const ShapeBox& box, vector<ShapeBox>& out) {
+    out.clear();
+    size_t x0 = grid.cellX(box.minX), x1 = grid.cellX(box.maxX);
+    size_t y0 = grid.cellY(box.minY), y1 = grid.cellY(box.maxY);
+    for (size_t y = y0; y <= y1; ++y) {
+        for (size_t x = x0; x <= x1; ++x) {
+            const vector<BoxGrid::GridEntry>& cell = grid.cell(x, y);
+            for (size_t k = 0; k < cell.size(); ++k) {
+                const ShapeBox& other = cell[k].box;
+                if (x == max(x0, cell[k].firstX) && y == max(y0, cell[k].firstY) &&
+                    other.minX < box.maxX && other.maxX > box.minX &&
+                    other.minY < box.maxY && other.maxY > box.minY &&
+                    !(other.isCircle == box.isCircle && other.index == box.index)) {
+                    out.push_back(other);
+                }
+            }
+        }
+    }
+}
+
+// Суммарная длина частей [lo, hi], не покрытых интервалами
+static double uncoveredLength(vector<Interval>& covered, double lo, double hi) {
+    sort(covered.begin(), covered.end());
+    double length = 0.0;
+    double position = lo;
+    for (size_t i = 0; i < covered.size() && position < hi; ++i) {
+        if (covered[i].first > position) {
+            length += min(covered[i].first, hi) - position;
+        }
+        position = max(position, covered[i].second);
+    }
+    if (position < hi) length += hi - position;
+    return length;
+}
+
+// Интеграл x dy - y dx по непокрытым дугам круга (углы дуг в [-pi, pi])
+static double uncoveredArcIntegral(vector<Interval>& covered, const Circle& c) {
+    sort(covered.begin(), covered.end());
+    double r = c.radius;
+    double integral = 0.0;
+    double position = -M_PI;
+    for (size_t i = 0; i <= covered.size(); ++i) {
+        double next = (i < covered.size()) ? covered[i].first : M_PI;
+        if (next > position) {
+            integral += r * r * (next - position) +
+                        r * c.center.x * (sin(next) - sin(position)) -
+                        r * c.center.y * (cos(next) - cos(position));
+            position = next;
+        }
+        if (i < covered.size()) position = max(position, covered[i].second);
+    }
+    return integral;
+}
+
+static void addArc(vector<Interval>& covered, double from, double to) {
+    if (from < -M_PI) {
+        covered.push_back(Interval(from + 2 * M_PI, M_PI));
+        covered.push_back(Interval(-M_PI, to));
+    } else if (to > M_PI) {
+        covered.push_back(Interval(from, M_PI));
+        covered.push_back(Interval(-M_PI, to - 2 * M_PI));
+    } else {
+        covered.push_back(Interval(from, to));
+    }
+}
+
+static void addAngle(vector<double>& angles, double angle) {
+    if (angle > M_PI) angle -= 2 * M_PI;
+    if (angle < -M_PI) angle += 2 * M_PI;
+    angles.push_back(angle);
+}
+
+// Вклад круга: дуги, не лежащие внутри других фигур
+static double circleContribution(const Scene& scene, size_t self, const vector<ShapeBox>& neighbours) {
+    const Circle& c = scene.circles[self];
+    double r = c.radius;
+    vector<Interval> covered;
+    vector<double> angles;
+
+    for (size_t k = 0; k < neighbours.size(); ++k) {
+        const ShapeBox& box = neighbours[k];
+        if (box.isCircle) {
+            const Circle& other = scene.circles[box.index];
+            double dx = other.center.x - c.center.x;
+            double dy = other.center.y - c.center.y;
+            // Из совпадающих кругов границу дает только первый
+            if (dx == 0 && dy == 0 && other.radius == r) {
+                if (box.index < self) return 0.0;
+                continue;
+            }
+            double d = sqrt(dx * dx + dy * dy);
+            if (d >= r + other.radius || d + other.radius <= r) continue;
+            if (d + r <= other.radius) return 0.0;
+            double a = atan2(dy, dx);
+            double cosH = (r * r + d * d - other.radius * other.radius) / (2 * r * d);
+            double h = acos(max(-1.0, min(1.0, cosH)));
+            addArc(covered, a - h, a + h);
+        } else {
+            const Square& s = scene.squares[box.index];
+            double left = s.topLeft.x;
+            double right = s.topLeft.x + s.side;
+            double top = s.topLeft.y;
+            double bottom = s.topLeft.y - s.side;
+
+            // Дуга делится точками пересечения со сторонами, середина каждой части проверяется
+            angles.clear();
+            angles.push_back(-M_PI);
+            angles.push_back(M_PI);
+            double xs[2] = {left, right};
+            double ys[2] = {bottom, top};
+            for (int i = 0; i < 2; ++i) {
+                double cx = (xs[i] - c.center.x) / r;
+                if (fabs(cx) <= 1) {
+                    double t = acos(cx);
+                    addAngle(angles, t);
+                    addAngle(angles, -t);
+                }
+                double cy = (ys[i] - c.center.y) / r;
+                if (fabs(cy) <= 1) {
+                    double t = asin(cy);
+                    addAngle(angles, t);
+                    addAngle(angles, M_PI - t);
+                }
+            }
+            sort(angles.begin(), angles.end());
+            for (size_t i = 0; i + 1 < angles.size(); ++i) {
+                if (angles[i + 1] <= angles[i]) continue;
+                double mid = (angles[i] + angles[i + 1]) / 2;
+                double px = c.center.x + r * cos(mid);
+                double py = c.center.y + r * sin(mid);
+                if (px > left && px < right && py > bottom && py < top) {
+                    covered.push_back(Interval(angles[i], angles[i + 1]));
+                }
+            }
+        }
+    }
+    return uncoveredArcIntegral(covered, c);
+}
+
+// Вклад квадрата: части сторон, не лежащие внутри других фигур.
+// Стороны обходятся против часовой стрелки; из совпадающих одинаково направленных
+// сторон границу дает только квадрат с меньшим номером, а встречные стороны
+// соседних квадратов взаимно уничтожаются в интеграле
+static double squareContribution(const Scene& scene, size_t self, const vector<ShapeBox>& neighbours) {
+    const Square& s = scene.squares[self];
+    double left = s.topLeft.x;
+    double right = s.topLeft.x + s.side;
+    double top = s.topLeft.y;
+    double bottom = s.topLeft.y - s.side;
+
+    // Стороны: 0 - нижняя, 1 - правая, 2 - верхняя, 3 - левая
+    double fixed[4] = {bottom, right, top, left};
+    double integral = 0.0;
+    vector<Interval> covered;
+
+    for (int side = 0; side < 4; ++side) {
+        bool horizontal = (side % 2 == 0);
+        double lo = horizontal ? left : bottom;
+        double hi = horizontal ? right : top;
+        double value = fixed[side];
+        covered.clear();
+
+        for (size_t k = 0; k < neighbours.size(); ++k) {
+            const ShapeBox& box = neighbours[k];
+            if (box.isCircle) {
+                const Circle& c = scene.circles[box.index];
+                double offset = value - (horizontal ? c.center.y : c.center.x);
+                double rest = c.radius * c.radius - offset * offset;
+                if (rest > 0) {
+                    double h = sqrt(rest);
+                    double center = horizontal ? c.center.x : c.center.y;
+                    covered.push_back(Interval(center - h, center + h));
+                }
+            } else {
+                const Square& o = scene.squares[box.index];
+                double oFixed[4] = {o.topLeft.y - o.side, o.topLeft.x + o.side, o.topLeft.y, o.topLeft.x};
+                double oLo = horizontal ? oFixed[3] : oFixed[0];
+                double oHi = horizontal ? oFixed[1] : oFixed[2];
+                double across0 = horizontal ? oFixed[0] : oFixed[3];
+                double across1 = horizontal ? oFixed[2] : oFixed[1];
+                bool inside = value > across0 && value < across1;
+                bool sameSide = value == oFixed[side] && box.index < self;
+                if (inside || sameSide) {
+                    covered.push_back(Interval(oLo, oHi));
+                }
+            }
+        }
+
+        double length = uncoveredLength(covered, lo, hi);
+        // Нижняя сторона идет по +x, правая по +y, верхняя по -x, левая по -y
+        switch (side) {
+            case 0: integral -= value * length; break;
+            case 1: integral += value * length; break;
+            case 2: integral += value * length; break;
+            case 3: integral -= value * length; break;
+        }
+    }
+    return integral;
+}
+
+double sceneUnionArea(const Scene& scene) {
+    if (scene.circles.empty()) {
+        return squaresUnionArea(scene.squares);
+    }
+
+    vector<ShapeBox> boxes;
+    boxes.reserve(scene.circles.size() + scene.squares.size());
+    for (size_t i = 0; i < scene.circles.size(); ++i) {
+        if (scene.circles[i].radius > 0) boxes.push_back(circleBox(scene.circles[i], i));
+    }
+    for (size_t i = 0; i < scene.squares.size(); ++i) {
+        if (scene.squares[i].side > 0) boxes.push_back(squareBox(scene.squares[i], i));
+    }
+    if (boxes.empty()) return 0.0;
+    BoxGrid grid(boxes);
+
+    size_t parts = workerCount(boxes.size(), AREA_SHAPES_PER_WORKER);
+    vector<double> partial(parts, 0.0);
+    parallelFor(parts, [&](size_t part) {
+        vector<ShapeBox> neighbours;
+        double sum = 0.0;
+        size_t end = chunkBegin(boxes.size(), parts, part + 1);
+        for (size_t i = chunkBegin(boxes.size(), parts, part); i < end; ++i) {
+            findNeighbours(grid, boxes[i], neighbours);
+            sum += boxes[i].isCircle ? circleContribution(scene, boxes[i].index, neighbours)
+                                     : squareContribution(scene, boxes[i].index, neighbours);
+        }
+        partial[part] = sum;
+    });
+
+    double integral = 0.0;
+    for (size_t part = 0; part < parts; ++part) {
+        integral += partial[part];
+    }
+    return integral / 2;
+}
+
+double circlesUnionArea(const vector<Circle>& circles) {
+    Scene scene;
+    scene.circles = circles;
+    return sceneUnionArea(scene);
+}
+
+// ---------- Монте-Карло ----------
+
+double monteCarloUnionArea(const Scene& scene, size_t samples, unsigned seed) {
+    vector<ShapeBox> boxes;
+    for (size_t i = 0; i < scene.circles.size(); ++i) {
+        if (scene.circles[i].radius > 0) boxes.push_back(circleBox(scene.circles[i], i));
+    }
+    for (size_t i = 0; i < scene.squares.size(); ++i) {
+        if (scene.squares[i].side > 0) boxes.push_back(squareBox(scene.squares[i], i));
+    }
+    if (boxes.empty() || samples == 0) return 0.0;
+
+    // Равномерная сетка, чтобы проверять точку только по фигурам своей клетки
+    BoxGrid grid(boxes);
+    double minX = grid.minX, maxX = grid.maxX;
+    double minY = grid.minY, maxY = grid.maxY;
+
+    size_t blocks = (samples + MONTE_CARLO_BLOCK - 1) / MONTE_CARLO_BLOCK;
+    size_t parts = workerCount(blocks, 1);
+    vector<size_t> hits(parts, 0);
+    parallelFor(parts, [&](size_t part) {
+        size_t count = 0;
+        size_t endBlock = chunkBegin(blocks, parts, part + 1);
+        for (size_t block = chunkBegin(blocks, parts, part); block < endBlock; ++block) {
+            seed_seq sequence{seed, static_cast<unsigned>(block), static_cast<unsigned>(block >> 32)};
+            mt19937_64 generator(sequence);
+            uniform_real_distribution<double> distX(minX, maxX);
+            uniform_real_distribution<double> distY(minY, maxY);
+            size_t blockSamples = min(MONTE_CARLO_BLOCK, samples - block * MONTE_CARLO_BLOCK);
+            for (size_t i = 0; i < blockSamples; ++i) {
+                double x = distX(generator);
+                double y = distY(generator);
+                const vector<BoxGrid::GridEntry>& cell = grid.cell(grid.cellX(x), grid.cellY(y));
+                for (size_t k = 0; k < cell.size(); ++k) {
+                    const ShapeBox& b = cell[k].box;
+                    bool inside;
+                    if (b.isCircle) {
+                        const Circle& c = scene.circles[b.index];
+                        double dx = x - c.center.x;
+                        double dy = y - c.center.y;
+                        inside = dx * dx + dy * dy < c.radius * c.radius;
+                    } else {
+                        inside = x > b.minX && x < b.maxX && y > b.minY && y < b.maxY;
+                    }
+                    if (inside) {
+                        ++count;
+                        break;
+                    }
+                }
+            }
+        }
+        hits[part] = count;
+    });
+
+    size_t total = 0;
+    for (size_t part = 0; part < parts; ++part) {
+        total += hits[part];
+    }
+    return (maxX - minX) * (maxY - minY) * total / samples;
+}
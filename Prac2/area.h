@@ -0,0 +1,23 @@
+#ifndef AREA_H
+#define AREA_H
+
+#include <cstddef>
+#include <vector>
+#include "scene.h"
+#include "structs.h"
+
+// Точная площадь объединения квадратов: заметание прямой по x с деревом отрезков по y,
+// полосы по x обрабатываются параллельно
+double squaresUnionArea(const std::vector<Square>& squares);
+
+// Точная площадь объединения кругов: формула Грина по непокрытым дугам
+double circlesUnionArea(const std::vector<Circle>& circles);
+
+// Точная площадь объединения кругов и квадратов: формула Грина по непокрытым
+// дугам и отрезкам границы (для сцены из одних квадратов используется заметание)
+double sceneUnionArea(const Scene& scene);
+
+// Оценка площади объединения методом Монте-Карло (для проверки и сравнения скорости)
+double monteCarloUnionArea(const Scene& scene, size_t samples, unsigned seed = 1);
+
+#endif
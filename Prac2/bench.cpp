@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "predicate_cases.h"
+
+using namespace std;
+
+// Замер пропускной способности проверок из func.h и func_batch.h.
+// bench [inputs] [seconds]: inputs - число входов в одном проходе,
+// seconds - минимальное время замера одного варианта.
+// Результат выводится в формате CSV
+
+struct BenchVisitor {
+    size_t count;
+    double minSeconds;
+    Circle circle;
+    Square square;
+    unsigned long long checksum;
+
+    template <typename Scalar, typename Batch>
+    void run(const char* name, InputKind kind, bool againstCircle, Scalar scalar, Batch batch) {
+        const char* distributions[2] = {"random", "boundary"};
+        for (int boundary = 0; boundary < 2; ++boundary) {
+            mt19937_64 gen(12345 + boundary);
+            PredicateInputs inputs;
+            makeInputs(gen, count, kind, againstCircle, boundary != 0, circle, square, inputs);
+            vector<unsigned char> out(count);
+
+            double scalarSeconds = 0;
+            size_t scalarQueries = 0;
+            while (scalarSeconds < minSeconds) {
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                for (size_t i = 0; i < count; ++i) {
+                    out[i] = scalar(inputs, i, circle, square);
+                }
+                scalarSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                scalarQueries += count;
+                checksum += out[count / 2];
+            }
+            report(name, "scalar", distributions[boundary], scalarQueries, scalarSeconds);
+
+            double batchSeconds = 0;
+            size_t batchQueries = 0;
+            while (batchSeconds < minSeconds) {
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                batch(inputs, count, circle, square, out.data());
+                batchSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                batchQueries += count;
+                checksum += out[count / 2];
+            }
+            report(name, "batch", distributions[boundary], batchQueries, batchSeconds);
+        }
+    }
+
+    void report(const char* name, const char* variant, const char* distribution, size_t queries, double seconds) {
+        cout << name << "," << variant << "," << distribution << "," << queries << ","
+             << seconds * 1e9 / queries << "," << queries / seconds << "\n";
+    }
+};
+
+int main(int argc, char* argv[]) {
+    BenchVisitor visitor;
+    visitor.count = (argc > 1) ? strtoull(argv[1], nullptr, 10) : (1 << 16);
+    visitor.minSeconds = (argc > 2) ? atof(argv[2]) : 0.2;
+    visitor.circle = Circle{{0.25, -0.5}, 1.5};
+    visitor.square = Square{{-1.0, 1.0}, 2.0};
+    visitor.checksum = 0;
+    if (visitor.count == 0) {
+        cerr << "Number of inputs must be positive" << endl;
+        return 1;
+    }
+
+    cout << "predicate,variant,distribution,queries,ns_per_query,queries_per_s\n";
+    forEachPredicate(visitor);
+    cerr << "checksum " << visitor.checksum << endl;
+    return 0;
+}
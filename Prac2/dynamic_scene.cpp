@@ -0,0 +1,297 @@
+#include "dynamic_scene.h"
+#include "func.h"
+#include "parallel.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace std;
+
+// Запас вокруг фигуры при раскладке по клеткам (больше EPSILON из func.h)
+const double GRID_MARGIN = 1e-4;
+
+// Фигура, занимающая больше клеток, хранится в списке больших фигур
+const double MAX_SHAPE_CELLS = 16;
+
+// Минимальное число сдвинутых фигур на один поток
+const size_t DIRTY_SHAPES_PER_WORKER = 256;
+
+static uint64_t cellKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+static ShapePair makePair(ShapeId a, ShapeId b) {
+    return a < b ? ShapePair{a, b} : ShapePair{b, a};
+}
+
+DynamicScene::DynamicScene(double cellSize) : cellSize(cellSize > 0 ? cellSize : 1.0) {}
+
+ShapeId DynamicScene::addShape(const Shape& shape) {
+    shapes.push_back(shape);
+    ShapeId id = shapes.size() - 1;
+    shapes[id].alive = true;
+    shapes[id].dirty = false;
+    shapes[id].inGrid = false;
+    markDirty(id);
+    return id;
+}
+
+ShapeId DynamicScene::addCircle(const Circle& c) {
+    Shape shape = Shape();
+    shape.isCircle = true;
+    shape.circle = c;
+    return addShape(shape);
+}
+
+ShapeId DynamicScene::addSquare(const Square& s) {
+    Shape shape = Shape();
+    shape.isCircle = false;
+    shape.square = s;
+    return addShape(shape);
+}
+
+void DynamicScene::removeShape(ShapeId id) {
+    shapes[id].alive = false;
+    markDirty(id);
+}
+
+void DynamicScene::moveTo(ShapeId id, const Point& position) {
+    Shape& shape = shapes[id];
+    if (shape.isCircle) {
+        shape.circle.center = position;
+    } else {
+        shape.square.topLeft = position;
+    }
+    markDirty(id);
+}
+
+void DynamicScene::moveBy(ShapeId id, double dx, double dy) {
+    Shape& shape = shapes[id];
+    Point& position = shape.isCircle ? shape.circle.center : shape.square.topLeft;
+    position.x += dx;
+    position.y += dy;
+    markDirty(id);
+}
+
+void DynamicScene::resize(ShapeId id, double size) {
+    Shape& shape = shapes[id];
+    if (shape.isCircle) {
+        shape.circle.radius = size;
+    } else {
+        shape.square.side = size;
+    }
+    markDirty(id);
+}
+
+void DynamicScene::markDirty(ShapeId id) {
+    if (!shapes[id].dirty) {
+        shapes[id].dirty = true;
+        dirtyShapes.push_back(id);
+    }
+}
+
+DynamicScene::CellRange DynamicScene::cellRange(const Shape& shape) const {
+    double minX, maxX, minY, maxY;
+    if (shape.isCircle) {
+        // circleSquareIntersect допускает EPSILON в квадрате расстояния,
+        // поэтому для маленьких кругов запас заметно больше EPSILON
+        const Circle& c = shape.circle;
+        double reach = sqrt(c.radius * c.radius + EPSILON);
+        minX = c.center.x - reach;
+        maxX = c.center.x + reach;
+        minY = c.center.y - reach;
+        maxY = c.center.y + reach;
+    } else {
+        const Square& s = shape.square;
+        minX = s.topLeft.x;
+        maxX = s.topLeft.x + s.side;
+        minY = s.topLeft.y - s.side;
+        maxY = s.topLeft.y;
+    }
+    double x0 = floor((minX - GRID_MARGIN) / cellSize);
+    double x1 = floor((maxX + GRID_MARGIN) / cellSize);
+    double y0 = floor((minY - GRID_MARGIN) / cellSize);
+    double y1 = floor((maxY + GRID_MARGIN) / cellSize);
+
+    // Номера клеток проверяются до приведения к int (NaN тоже не проходит)
+    CellRange range = CellRange();
+    bool inRange = x0 >= INT_MIN && x1 <= INT_MAX && y0 >= INT_MIN && y1 <= INT_MAX;
+    range.large = !inRange || (x1 - x0 + 1) * (y1 - y0 + 1) > MAX_SHAPE_CELLS;
+    if (!range.large) {
+        range.x0 = static_cast<int>(x0);
+        range.x1 = static_cast<int>(x1);
+        range.y0 = static_cast<int>(y0);
+        range.y1 = static_cast<int>(y1);
+    }
+    return range;
+}
+
+bool DynamicScene::sameCells(const CellRange& a, const CellRange& b) {
+    if (a.large || b.large) return a.large == b.large;
+    return a.x0 == b.x0 && a.x1 == b.x1 && a.y0 == b.y0 && a.y1 == b.y1;
+}
+
+void DynamicScene::insertIntoGrid(ShapeId id, const CellRange& range) {
+    if (range.large) {
+        largeShapes.push_back(id);
+        return;
+    }
+    for (int y = range.y0; y <= range.y1; ++y) {
+        for (int x = range.x0; x <= range.x1; ++x) {
+            grid[cellKey(x, y)].push_back(id);
+        }
+    }
+}
+
+void DynamicScene::removeFromGrid(ShapeId id, const CellRange& range) {
+    if (range.large) {
+        largeShapes.erase(find(largeShapes.begin(), largeShapes.end(), id));
+        return;
+    }
+    for (int y = range.y0; y <= range.y1; ++y) {
+        for (int x = range.x0; x <= range.x1; ++x) {
+            unordered_map<uint64_t, vector<ShapeId> >::iterator cell = grid.find(cellKey(x, y));
+            if (cell == grid.end()) continue;
+            vector<ShapeId>& ids = cell->second;
+            for (size_t i = 0; i < ids.size(); ++i) {
+                if (ids[i] == id) {
+                    ids[i] = ids.back();
+                    ids.pop_back();
+                    break;
+                }
+            }
+            if (ids.empty()) grid.erase(cell);
+        }
+    }
+}
+
+bool DynamicScene::shapesIntersect(const Shape& a, const Shape& b) const {
+    if (a.isCircle && b.isCircle) return circlesIntersect(a.circle, b.circle);
+    if (!a.isCircle && !b.isCircle) return squaresIntersect(a.square, b.square);
+    if (a.isCircle) return circleSquareIntersect(a.circle, b.square);
+    return circleSquareIntersect(b.circle, a.square);
+}
+
+// Отсортированный список фигур, пересекающихся с фигурой id
+void DynamicScene::findContacts(ShapeId id, vector<ShapeId>& out) const {
+    out.clear();
+    const Shape& shape = shapes[id];
+    if (!shape.alive) return;
+
+    const CellRange& range = shape.cells;
+    if (range.large) {
+        // Большая фигура проверяется со всеми: время зависит от числа фигур, а не от ее площади
+        for (ShapeId other = 0; other < shapes.size(); ++other) {
+            if (shapes[other].alive) out.push_back(other);
+        }
+    } else {
+        for (int y = range.y0; y <= range.y1; ++y) {
+            for (int x = range.x0; x <= range.x1; ++x) {
+                unordered_map<uint64_t, vector<ShapeId> >::const_iterator cell = grid.find(cellKey(x, y));
+                if (cell == grid.end()) continue;
+                out.insert(out.end(), cell->second.begin(), cell->second.end());
+            }
+        }
+        out.insert(out.end(), largeShapes.begin(), largeShapes.end());
+        sort(out.begin(), out.end());
+        out.erase(unique(out.begin(), out.end()), out.end());
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (out[i] != id && shapesIntersect(shape, shapes[out[i]])) {
+            out[kept++] = out[i];
+        }
+    }
+    out.resize(kept);
+}
+
+TickResult DynamicScene::tick() {
+    TickResult result;
+
+    // Сетка обновляется только для фигур, сменивших набор клеток
+    for (size_t k = 0; k < dirtyShapes.size(); ++k) {
+        ShapeId id = dirtyShapes[k];
+        Shape& shape = shapes[id];
+        if (!shape.alive) {
+            if (shape.inGrid) removeFromGrid(id, shape.cells);
+            shape.inGrid = false;
+            continue;
+        }
+        CellRange range = cellRange(shape);
+        if (shape.inGrid && sameCells(range, shape.cells)) {
+            continue;
+        }
+        if (shape.inGrid) removeFromGrid(id, shape.cells);
+        insertIntoGrid(id, range);
+        shape.cells = range;
+        shape.inGrid = true;
+    }
+
+    // Новые контакты сдвинутых фигур ищутся параллельно (сетка только читается)
+    vector<vector<ShapeId> > found(dirtyShapes.size());
+    size_t parts = workerCount(dirtyShapes.size(), DIRTY_SHAPES_PER_WORKER);
+    parallelFor(parts, [&](size_t part) {
+        size_t end = chunkBegin(dirtyShapes.size(), parts, part + 1);
+        for (size_t k = chunkBegin(dirtyShapes.size(), parts, part); k < end; ++k) {
+            findContacts(dirtyShapes[k], found[k]);
+        }
+    });
+
+    // Сравнение со старыми контактами; пару двух сдвинутых фигур учитывает фигура с меньшим номером
+    for (size_t k = 0; k < dirtyShapes.size(); ++k) {
+        ShapeId id = dirtyShapes[k];
+        vector<ShapeId> old = shapes[id].contacts;
+        sort(old.begin(), old.end());
+        const vector<ShapeId>& now = found[k];
+
+        size_t i = 0, j = 0;
+        while (i < old.size() || j < now.size()) {
+            if (j == now.size() || (i < old.size() && old[i] < now[j])) {
+                if (!shapes[old[i]].dirty || id < old[i]) result.stopped.push_back(makePair(id, old[i]));
+                ++i;
+            } else if (i == old.size() || now[j] < old[i]) {
+                if (!shapes[now[j]].dirty || id < now[j]) result.started.push_back(makePair(id, now[j]));
+                ++j;
+            } else {
+                ++i;
+                ++j;
+            }
+        }
+    }
+
+    for (size_t k = 0; k < result.stopped.size(); ++k) {
+        const ShapePair& pair = result.stopped[k];
+        vector<ShapeId>& a = shapes[pair.first].contacts;
+        vector<ShapeId>& b = shapes[pair.second].contacts;
+        a.erase(find(a.begin(), a.end(), pair.second));
+        b.erase(find(b.begin(), b.end(), pair.first));
+    }
+    for (size_t k = 0; k < result.started.size(); ++k) {
+        const ShapePair& pair = result.started[k];
+        shapes[pair.first].contacts.push_back(pair.second);
+        shapes[pair.second].contacts.push_back(pair.first);
+    }
+
+    for (size_t k = 0; k < dirtyShapes.size(); ++k) {
+        shapes[dirtyShapes[k]].dirty = false;
+    }
+    dirtyShapes.clear();
+    return result;
+}
+
+bool DynamicScene::touching(ShapeId a, ShapeId b) const {
+    const vector<ShapeId>& contacts = shapes[a].contacts;
+    return find(contacts.begin(), contacts.end(), b) != contacts.end();
+}
+
+vector<ShapePair> DynamicScene::currentPairs() const {
+    vector<ShapePair> pairs;
+    for (ShapeId id = 0; id < shapes.size(); ++id) {
+        const vector<ShapeId>& contacts = shapes[id].contacts;
+        for (size_t i = 0; i < contacts.size(); ++i) {
+            if (id < contacts[i]) pairs.push_back(ShapePair{id, contacts[i]});
+        }
+    }
+    return pairs;
+}
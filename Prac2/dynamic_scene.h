@@ -0,0 +1,92 @@
+#ifndef DYNAMIC_SCENE_H
+#define DYNAMIC_SCENE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "structs.h"
+
+// Номер фигуры в динамической сцене (не переиспользуется после удаления)
+typedef size_t ShapeId;
+
+// Пара пересекающихся фигур, first < second
+struct ShapePair {
+    ShapeId first;
+    ShapeId second;
+};
+
+// Изменения за такт: пары, которые начали и перестали пересекаться
+struct TickResult {
+    std::vector<ShapePair> started;
+    std::vector<ShapePair> stopped;
+};
+
+// Сцена из движущихся кругов и квадратов. Изменения накапливаются и применяются
+// в tick(): равномерная сетка обновляется только для сдвинутых фигур, и только
+// для них заново проверяются пересечения (функциями из func.h).
+// Фигуры больше MAX_SHAPE_CELLS клеток (или за пределами номеров клеток)
+// хранятся отдельным списком и проверяются со всеми фигурами напрямую, поэтому
+// время такта не зависит от площади фигур
+class DynamicScene {
+public:
+    // cellSize - размер клетки сетки, порядка типичного размера фигуры
+    explicit DynamicScene(double cellSize);
+
+    ShapeId addCircle(const Circle& c);
+    ShapeId addSquare(const Square& s);
+    void removeShape(ShapeId id);
+
+    // Новое положение: центр для круга, левый верхний угол для квадрата
+    void moveTo(ShapeId id, const Point& position);
+    void moveBy(ShapeId id, double dx, double dy);
+    // Новый радиус круга или сторона квадрата
+    void resize(ShapeId id, double size);
+
+    TickResult tick();
+
+    size_t shapeCount() const { return shapes.size(); }
+    bool isAlive(ShapeId id) const { return shapes[id].alive; }
+    bool isCircle(ShapeId id) const { return shapes[id].isCircle; }
+    const Circle& circle(ShapeId id) const { return shapes[id].circle; }
+    const Square& square(ShapeId id) const { return shapes[id].square; }
+
+    // Пересекающиеся пары на момент последнего tick()
+    bool touching(ShapeId a, ShapeId b) const;
+    std::vector<ShapePair> currentPairs() const;
+
+private:
+    // Клетки фигуры; large - фигура в списке больших, клетки не используются
+    struct CellRange {
+        int x0, y0, x1, y1;
+        bool large;
+    };
+
+    struct Shape {
+        bool isCircle;
+        bool alive;
+        bool dirty;
+        bool inGrid;
+        Circle circle;
+        Square square;
+        CellRange cells;
+        std::vector<ShapeId> contacts;
+    };
+
+    ShapeId addShape(const Shape& shape);
+    void markDirty(ShapeId id);
+    CellRange cellRange(const Shape& shape) const;
+    void insertIntoGrid(ShapeId id, const CellRange& range);
+    void removeFromGrid(ShapeId id, const CellRange& range);
+    static bool sameCells(const CellRange& a, const CellRange& b);
+    bool shapesIntersect(const Shape& a, const Shape& b) const;
+    void findContacts(ShapeId id, std::vector<ShapeId>& out) const;
+
+    double cellSize;
+    std::vector<Shape> shapes;
+    std::vector<ShapeId> dirtyShapes;
+    std::unordered_map<uint64_t, std::vector<ShapeId> > grid;
+    std::vector<ShapeId> largeShapes;
+};
+
+#endif
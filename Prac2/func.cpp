@@ -4,8 +4,6 @@
 
 using namespace std;
 
-const double EPSILON = 1e-5;
-
 // Вспомогательная функция для сравнения double с учетом погрешности
 bool areEqual(double a, double b) {
     return fabs(a - b) < EPSILON;
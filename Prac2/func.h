@@ -3,6 +3,9 @@
 
 #include "structs.h"
 
+// Погрешность сравнения координат
+const double EPSILON = 1e-5;
+
 // Функции для точки
 void readPoint(Point& p);
 void printPoint(const Point& p);
@@ -0,0 +1,152 @@
+#include "func_batch.h"
+#include "func.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Выражения повторяют func.cpp дословно, чтобы результаты совпадали до бита;
+// вместо && используется &, чтобы в цикле не было ветвлений
+
+void pointsInsideCircle(const double* x, const double* y, size_t n, const Circle& c, unsigned char* out) {
+    const double cx = c.center.x;
+    const double cy = c.center.y;
+    const double limit = c.radius * c.radius - EPSILON;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = x[i] - cx;
+        double dy = y[i] - cy;
+        double distanceSquared = dx * dx + dy * dy;
+        out[i] = distanceSquared < limit;
+    }
+}
+
+void pointsInsideSquare(const double* x, const double* y, size_t n, const Square& s, unsigned char* out) {
+    const double left = s.topLeft.x + EPSILON;
+    const double right = s.topLeft.x + s.side - EPSILON;
+    const double top = s.topLeft.y - EPSILON;
+    const double bottom = s.topLeft.y - s.side + EPSILON;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = (x[i] > left) & (x[i] < right) & (y[i] < top) & (y[i] > bottom);
+    }
+}
+
+void pointsOnCircle(const double* x, const double* y, size_t n, const Circle& c, unsigned char* out) {
+    const double cx = c.center.x;
+    const double cy = c.center.y;
+    const double radiusSquared = c.radius * c.radius;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = x[i] - cx;
+        double dy = y[i] - cy;
+        double distanceSquared = dx * dx + dy * dy;
+        out[i] = fabs(distanceSquared - radiusSquared) < EPSILON;
+    }
+}
+
+void pointsOnSquare(const double* x, const double* y, size_t n, const Square& s, unsigned char* out) {
+    const double left = s.topLeft.x;
+    const double right = s.topLeft.x + s.side;
+    const double top = s.topLeft.y;
+    const double bottom = s.topLeft.y - s.side;
+    for (size_t i = 0; i < n; ++i) {
+        bool onVertical = ((fabs(x[i] - left) < EPSILON) | (fabs(x[i] - right) < EPSILON)) &
+                          (y[i] <= top + EPSILON) & (y[i] >= bottom - EPSILON);
+        bool onHorizontal = ((fabs(y[i] - top) < EPSILON) | (fabs(y[i] - bottom) < EPSILON)) &
+                            (x[i] >= left - EPSILON) & (x[i] <= right + EPSILON);
+        out[i] = onVertical | onHorizontal;
+    }
+}
+
+void circlesIntersectCircle(const double* cx, const double* cy, const double* r, size_t n,
+                            const Circle& c, unsigned char* out) {
+    for (size_t i = 0; i < n; ++i) {
+        double dx = cx[i] - c.center.x;
+        double dy = cy[i] - c.center.y;
+        double distance = sqrt(dx * dx + dy * dy);
+        double sumRadii = r[i] + c.radius;
+        double diffRadii = fabs(r[i] - c.radius);
+        out[i] = (distance <= sumRadii + EPSILON) & (distance >= diffRadii - EPSILON);
+    }
+}
+
+void squaresIntersectSquare(const double* x, const double* y, const double* side, size_t n,
+                            const Square& s, unsigned char* out) {
+    const double left2 = s.topLeft.x;
+    const double right2 = s.topLeft.x + s.side;
+    const double top2 = s.topLeft.y;
+    const double bottom2 = s.topLeft.y - s.side;
+    for (size_t i = 0; i < n; ++i) {
+        double left1 = x[i];
+        double right1 = x[i] + side[i];
+        double top1 = y[i];
+        double bottom1 = y[i] - side[i];
+        out[i] = !((right1 < left2 - EPSILON) | (left1 > right2 + EPSILON) |
+                   (bottom1 > top2 + EPSILON) | (top1 < bottom2 - EPSILON));
+    }
+}
+
+void circlesIntersectSquare(const double* cx, const double* cy, const double* r, size_t n,
+                            const Square& s, unsigned char* out) {
+    const double left = s.topLeft.x;
+    const double right = s.topLeft.x + s.side;
+    const double top = s.topLeft.y;
+    const double bottom = s.topLeft.y - s.side;
+    for (size_t i = 0; i < n; ++i) {
+        double closestX = max(left, min(cx[i], right));
+        double closestY = max(bottom, min(cy[i], top));
+        double dx = cx[i] - closestX;
+        double dy = cy[i] - closestY;
+        double distanceSquared = dx * dx + dy * dy;
+        out[i] = distanceSquared <= r[i] * r[i] + EPSILON;
+    }
+}
+
+void circlesInsideCircle(const double* cx, const double* cy, const double* r, size_t n,
+                         const Circle& c, unsigned char* out) {
+    const double limit = c.radius + EPSILON;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = cx[i] - c.center.x;
+        double dy = cy[i] - c.center.y;
+        double distance = sqrt(dx * dx + dy * dy);
+        out[i] = distance + r[i] <= limit;
+    }
+}
+
+void squaresInsideSquare(const double* x, const double* y, const double* side, size_t n,
+                         const Square& s, unsigned char* out) {
+    const double left2 = s.topLeft.x - EPSILON;
+    const double right2 = s.topLeft.x + s.side + EPSILON;
+    const double top2 = s.topLeft.y + EPSILON;
+    const double bottom2 = s.topLeft.y - s.side - EPSILON;
+    for (size_t i = 0; i < n; ++i) {
+        double right1 = x[i] + side[i];
+        double bottom1 = y[i] - side[i];
+        out[i] = (x[i] >= left2) & (right1 <= right2) & (y[i] <= top2) & (bottom1 >= bottom2);
+    }
+}
+
+void squaresInsideCircle(const double* x, const double* y, const double* side, size_t n,
+                         const Circle& c, unsigned char* out) {
+    const double cx = c.center.x;
+    const double cy = c.center.y;
+    const double limit = c.radius * c.radius - EPSILON;
+    for (size_t i = 0; i < n; ++i) {
+        double left = x[i] - cx;
+        double right = (x[i] + side[i]) - cx;
+        double top = y[i] - cy;
+        double bottom = (y[i] - side[i]) - cy;
+        out[i] = (left * left + top * top < limit) & (right * right + top * top < limit) &
+                 (left * left + bottom * bottom < limit) & (right * right + bottom * bottom < limit);
+    }
+}
+
+void circlesInsideSquare(const double* cx, const double* cy, const double* r, size_t n,
+                         const Square& s, unsigned char* out) {
+    const double left = s.topLeft.x - EPSILON;
+    const double right = s.topLeft.x + s.side + EPSILON;
+    const double top = s.topLeft.y + EPSILON;
+    const double bottom = s.topLeft.y - s.side - EPSILON;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = (cx[i] - r[i] >= left) & (cx[i] + r[i] <= right) &
+                 (cy[i] + r[i] <= top) & (cy[i] - r[i] >= bottom);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef FUNC_BATCH_H
+#define FUNC_BATCH_H
+
+#include <cstddef>
+#include "structs.h"
+
+// Пакетные версии проверок из func.h для массивов SoA (например, из SceneView).
+// Циклы без ветвлений векторизуются компилятором; результат для i-го элемента
+// записывается в out[i] (1 или 0) и совпадает с результатом скалярной функции
+
+// Точки (x[i], y[i]) и одна фигура
+void pointsInsideCircle(const double* x, const double* y, size_t n, const Circle& c, unsigned char* out);
+void pointsInsideSquare(const double* x, const double* y, size_t n, const Square& s, unsigned char* out);
+void pointsOnCircle(const double* x, const double* y, size_t n, const Circle& c, unsigned char* out);
+void pointsOnSquare(const double* x, const double* y, size_t n, const Square& s, unsigned char* out);
+
+// Круги (cx[i], cy[i], r[i]) или квадраты (x[i], y[i], side[i]) и одна фигура
+void circlesIntersectCircle(const double* cx, const double* cy, const double* r, size_t n,
+                            const Circle& c, unsigned char* out);
+void squaresIntersectSquare(const double* x, const double* y, const double* side, size_t n,
+                            const Square& s, unsigned char* out);
+void circlesIntersectSquare(const double* cx, const double* cy, const double* r, size_t n,
+                            const Square& s, unsigned char* out);
+
+// i-я фигура лежит внутри заданной
+void circlesInsideCircle(const double* cx, const double* cy, const double* r, size_t n,
+                         const Circle& c, unsigned char* out);
+void squaresInsideSquare(const double* x, const double* y, const double* side, size_t n,
+                         const Square& s, unsigned char* out);
+void squaresInsideCircle(const double* x, const double* y, const double* side, size_t n,
+                         const Circle& c, unsigned char* out);
+void circlesInsideSquare(const double* cx, const double* cy, const double* r, size_t n,
+                         const Square& s, unsigned char* out);
+
+#endif
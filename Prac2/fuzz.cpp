@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "dynamic_scene.h"
+#include "parallel.h"
+#include "predicate_cases.h"
+#include "query.h"
+#include "scene.h"
+
+#ifndef _WIN32
+#include <csignal>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Случайная сравнительная проверка: пакетные версии из func_batch.h и контакты
+// DynamicScene сверяются со скалярными функциями из func.h на входах у границы EPSILON;
+// сцены сохраняются в текстовом и двоичном формате и загружаются обратно из файла и канала;
+// ответы на пакетные запросы (в том числе ошибочные) сверяются с прямыми вызовами func.h.
+// fuzz [rounds] [seed]
+
+const size_t FUZZ_INPUTS = 512;
+
+struct FuzzVisitor {
+    mt19937_64* gen;
+    Circle circle;
+    Square square;
+    size_t checks;
+    size_t failures;
+
+    template <typename Scalar, typename Batch>
+    void run(const char* name, InputKind kind, bool againstCircle, Scalar scalar, Batch batch) {
+        for (int boundary = 0; boundary < 2; ++boundary) {
+            PredicateInputs inputs;
+            makeInputs(*gen, FUZZ_INPUTS, kind, againstCircle, boundary != 0, circle, square, inputs);
+            vector<unsigned char> out(FUZZ_INPUTS);
+            batch(inputs, FUZZ_INPUTS, circle, square, out.data());
+            for (size_t i = 0; i < FUZZ_INPUTS; ++i) {
+                ++checks;
+                bool expected = scalar(inputs, i, circle, square);
+                if (expected != (out[i] != 0)) {
+                    reportFailure(name, kind, inputs, i, expected);
+                }
+            }
+        }
+    }
+
+    void reportFailure(const char* name, InputKind kind, const PredicateInputs& in, size_t i, bool expected) {
+        if (++failures > 20) return;
+        printf("MISMATCH %s: scalar %d, batch %d\n", name, expected, !expected);
+        switch (kind) {
+            case POINT_INPUT:
+                printf("  point (%.17g, %.17g)\n", in.points.x[i], in.points.y[i]);
+                break;
+            case CIRCLE_INPUT:
+                printf("  circle (%.17g, %.17g) r %.17g\n", in.circles.x[i], in.circles.y[i], in.circles.r[i]);
+                break;
+            case SQUARE_INPUT:
+                printf("  square (%.17g, %.17g) side %.17g\n", in.squares.x[i], in.squares.y[i], in.squares.side[i]);
+                break;
+        }
+        printf("  reference circle (%.17g, %.17g) r %.17g, square (%.17g, %.17g) side %.17g\n",
+               circle.center.x, circle.center.y, circle.radius,
+               square.topLeft.x, square.topLeft.y, square.side);
+    }
+};
+
+static bool shapesIntersect(const DynamicScene& scene, ShapeId a, ShapeId b) {
+    bool circleA = scene.isCircle(a);
+    bool circleB = scene.isCircle(b);
+    if (circleA && circleB) return circlesIntersect(scene.circle(a), scene.circle(b));
+    if (!circleA && !circleB) return squaresIntersect(scene.square(a), scene.square(b));
+    if (circleA) return circleSquareIntersect(scene.circle(a), scene.square(b));
+    return circleSquareIntersect(scene.circle(b), scene.square(a));
+}
+
+// Фигуры касаются опорного круга и квадрата, затем сдвигаются на доли EPSILON;
+// среди них большие и очень далекие от начала координат.
+// Пары DynamicScene сравниваются с полным перебором
+static bool checkDynamicScene(mt19937_64& gen, const Circle& circle, const Square& square, size_t& checks) {
+    DynamicScene scene(max(circle.radius, square.side));
+    CircleSet circles;
+    SquareSet squares;
+    circlesNearSquare(gen, 32, square, circles);
+    squaresNearCircle(gen, 32, circle, squares);
+    scene.addCircle(circle);
+    scene.addSquare(square);
+    for (size_t i = 0; i < 32; ++i) {
+        scene.addCircle(Circle{{circles.x[i], circles.y[i]}, circles.r[i]});
+        scene.addSquare(Square{{squares.x[i], squares.y[i]}, squares.side[i]});
+    }
+
+    // Большие фигуры (в списке больших) касаются опорных краем
+    double cell = max(circle.radius, square.side);
+    double right = square.topLeft.x + square.side + boundaryOffset(gen);
+    ShapeId largeSquare = scene.addSquare(Square{{right, square.topLeft.y + 500 * cell}, 1000 * cell});
+    double bigRadius = 300 * cell;
+    scene.addCircle(Circle{{circle.center.x - circle.radius - bigRadius + boundaryOffset(gen), circle.center.y}, bigRadius});
+    // Пара кругов дальше 2^31 клеток от начала координат
+    double far = (gen() % 2 ? 1 : -1) * uniform(gen, 3e9, 1e12) * cell;
+    double farRadius = uniform(gen, 0.1, 1.0) * cell;
+    scene.addCircle(Circle{{far, far}, farRadius});
+    scene.addCircle(Circle{{far + 2 * farRadius * (1 + 1e-15 * (gen() % 3)), far}, farRadius});
+
+    for (int tick = 0; tick < 4; ++tick) {
+        if (tick > 0) {
+            for (ShapeId id = 0; id < scene.shapeCount(); ++id) {
+                if (gen() % 2) scene.moveBy(id, boundaryOffset(gen) / 4, boundaryOffset(gen) / 4);
+            }
+        }
+        if (tick == 2) {
+            scene.moveBy(largeSquare, cell / 2, 0);
+        }
+        scene.tick();
+        for (ShapeId a = 0; a < scene.shapeCount(); ++a) {
+            for (ShapeId b = a + 1; b < scene.shapeCount(); ++b) {
+                ++checks;
+                if (scene.touching(a, b) != shapesIntersect(scene, a, b)) {
+                    printf("MISMATCH DynamicScene: shapes %zu and %zu at tick %d\n", a, b, tick);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static void randomScene(mt19937_64& gen, Scene& scene) {
+    double scale = pow(10.0, uniform(gen, -3.0, 6.0));
+    scene.circles.resize(gen() % 200);
+    scene.squares.resize(gen() % 200);
+    for (size_t i = 0; i < scene.circles.size(); ++i) {
+        scene.circles[i] = Circle{{uniform(gen, -scale, scale), uniform(gen, -scale, scale)}, uniform(gen, 0, scale)};
+    }
+    for (size_t i = 0; i < scene.squares.size(); ++i) {
+        scene.squares[i] = Square{{uniform(gen, -scale, scale), uniform(gen, -scale, scale)}, uniform(gen, 0, scale)};
+    }
+}
+
+static bool sameScene(const Scene& a, const Scene& b) {
+    if (a.circles.size() != b.circles.size() || a.squares.size() != b.squares.size()) return false;
+    for (size_t i = 0; i < a.circles.size(); ++i) {
+        const Circle& x = a.circles[i];
+        const Circle& y = b.circles[i];
+        if (x.center.x != y.center.x || x.center.y != y.center.y || x.radius != y.radius) return false;
+    }
+    for (size_t i = 0; i < a.squares.size(); ++i) {
+        const Square& x = a.squares[i];
+        const Square& y = b.squares[i];
+        if (x.topLeft.x != y.topLeft.x || x.topLeft.y != y.topLeft.y || x.side != y.side) return false;
+    }
+    return true;
+}
+
+#ifndef _WIN32
+// Загрузка файла через канал /dev/fd/N: размер неизвестен, перемотка невозможна
+static bool loadSceneFromPipe(const string& filename, Scene& scene) {
+    ifstream file(filename, ios::binary);
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    thread writer([&]() {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = write(fds[1], data.data() + written, data.size() - written);
+            if (n <= 0) break;
+            written += static_cast<size_t>(n);
+        }
+        close(fds[1]);
+    });
+    bool ok = loadScene("/dev/fd/" + to_string(fds[0]), scene);
+    // Закрытие чтения завершает запись, если загрузка остановилась раньше
+    close(fds[0]);
+    writer.join();
+    return ok;
+}
+#endif
+
+// Сохранение в обоих форматах и загрузка из файла и канала дают ту же сцену;
+// загрузка заменяет прежнее содержимое
+static bool checkSceneFiles(mt19937_64& gen, const string& path, size_t& checks) {
+    Scene scene;
+    randomScene(gen, scene);
+    for (int binary = 0; binary < 2; ++binary) {
+        bool saved = binary ? saveSceneBinary(path, scene) : saveSceneText(path, scene);
+        for (int fromPipe = 0; fromPipe < 2; ++fromPipe) {
+#ifdef _WIN32
+            if (fromPipe) continue;
+#endif
+            Scene loaded;
+            randomScene(gen, loaded);
+            bool ok = saved;
+#ifndef _WIN32
+            if (ok && fromPipe) ok = loadSceneFromPipe(path, loaded);
+#endif
+            if (ok && !fromPipe) ok = loadScene(path, loaded);
+            ++checks;
+            if (!ok || !sameScene(scene, loaded)) {
+                printf("MISMATCH scene %s round trip from %s: %zu circles, %zu squares\n",
+                       binary ? "binary" : "text", fromPipe ? "pipe" : "file",
+                       scene.circles.size(), scene.squares.size());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Ошибочная строка у границы кусков параллельного разбора: номер строки
+// в сообщении считается по всему тексту, сцена не меняется
+static bool checkParseErrorAtChunkBoundary(mt19937_64& gen, size_t& checks) {
+    size_t targetParts = min<size_t>(workerCount(4 * PARSE_CHUNK_BYTES, PARSE_CHUNK_BYTES), 4);
+    size_t targetBytes = max<size_t>(targetParts, 2) * PARSE_CHUNK_BYTES + gen() % 4096;
+    string text;
+    vector<size_t> lineStarts;
+    while (text.size() < targetBytes) {
+        lineStarts.push_back(text.size());
+        switch (gen() % 8) {
+            case 0: text += "# comment\n"; break;
+            case 1: text += "\n"; break;
+            default: text += (gen() % 2 ? "C " : "S ") + to_string(uniform(gen, -1e3, 1e3)) + " " +
+                             to_string(uniform(gen, -1e3, 1e3)) + " " + to_string(uniform(gen, 0, 1e3)) + "\n";
+        }
+    }
+
+    // Строка, в которую попадает граница куска (последняя в куске), или следующая (первая)
+    size_t parts = workerCount(text.size(), PARSE_CHUNK_BYTES);
+    size_t part = (parts > 1) ? 1 + gen() % (parts - 1) : 1;
+    size_t offset = (parts > 1) ? chunkBegin(text.size(), parts, part) : text.size() / 2;
+    size_t line = static_cast<size_t>(upper_bound(lineStarts.begin(), lineStarts.end(), offset) - lineStarts.begin()) - 1;
+    line = min(line + gen() % 2, lineStarts.size() - 1);
+    text.insert(lineStarts[line], "X 1 2 3\n");
+
+    Scene scene;
+    randomScene(gen, scene);
+    Scene original = scene;
+    ostringstream message;
+    streambuf* errors = cerr.rdbuf(message.rdbuf());
+    bool ok = parseSceneText(text.data(), text.data() + text.size(), scene);
+    cerr.rdbuf(errors);
+
+    ++checks;
+    string expected = "Invalid shape record at line " + to_string(line + 1) + "\n";
+    if (ok || message.str() != expected || !sameScene(scene, original)) {
+        printf("MISMATCH parse error at chunk boundary: expected \"%s\", got \"%s\"\n",
+               expected.substr(0, expected.size() - 1).c_str(), message.str().c_str());
+        return false;
+    }
+    return true;
+}
+
+static string numberText(double value) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.17g", value);
+    return text;
+}
+
+// Случайный запрос к сцене и ожидаемая строка ответа ("" для пропускаемой строки).
+// Точки берутся на контуре или рядом с ним, часть запросов испорчена
+static string randomQuery(mt19937_64& gen, const Scene& scene, string& expected) {
+    bool circleA = gen() % 2;
+    bool circleB = gen() % 2;
+    size_t a = gen() % (circleA ? scene.circles.size() : scene.squares.size());
+    size_t b = gen() % (circleB ? scene.circles.size() : scene.squares.size());
+    string refA = (circleA ? "c" : "s") + to_string(a);
+    string refB = (circleB ? "c" : "s") + to_string(b);
+    const char* blank = (gen() % 4 == 0) ? "\t" : " ";
+
+    Point p;
+    if (circleA) {
+        const Circle& c = scene.circles[a];
+        double angle = uniform(gen, 0, 6.283185307179586);
+        p = Point{c.center.x + c.radius * cos(angle), c.center.y + c.radius * sin(angle)};
+    } else {
+        const Square& q = scene.squares[a];
+        p = Point{q.topLeft.x + q.side * (gen() % 3) / 2, q.topLeft.y - q.side * uniform(gen, 0, 1)};
+    }
+    if (gen() % 2) {
+        p.x += boundaryOffset(gen);
+        p.y += boundaryOffset(gen);
+    }
+    string point = numberText(p.x) + blank + numberText(p.y);
+
+    bool answer = false;
+    string line;
+    switch (gen() % 4) {
+        case 0:
+            line = "in " + point + blank + refA;
+            answer = circleA ? isPointInsideCircle(p, scene.circles[a]) : isPointInsideSquare(p, scene.squares[a]);
+            break;
+        case 1:
+            line = "on " + point + blank + refA;
+            answer = circleA ? isPointOnCircle(p, scene.circles[a]) : isPointOnSquare(p, scene.squares[a]);
+            break;
+        case 2:
+            line = "intersect " + refA + blank + refB;
+            if (circleA && circleB) answer = circlesIntersect(scene.circles[a], scene.circles[b]);
+            else if (!circleA && !circleB) answer = squaresIntersect(scene.squares[a], scene.squares[b]);
+            else if (circleA) answer = circleSquareIntersect(scene.circles[a], scene.squares[b]);
+            else answer = circleSquareIntersect(scene.circles[b], scene.squares[a]);
+            break;
+        default:
+            line = "contains " + refA + blank + refB;
+            if (circleA && circleB) answer = isCircleInsideCircle(scene.circles[b], scene.circles[a]);
+            else if (!circleA && !circleB) answer = isSquareInsideSquare(scene.squares[b], scene.squares[a]);
+            else if (circleA) answer = isSquareInsideCircle(scene.squares[b], scene.circles[a]);
+            else answer = isCircleInsideSquare(scene.circles[b], scene.squares[a]);
+            break;
+    }
+    expected = answer ? "1\n" : "0\n";
+
+    switch (gen() % 12) {
+        case 0: line += " extra"; break;
+        case 1: line = line.substr(0, line.rfind(blank)); break;
+        case 2: line = "inside" + line.substr(line.find(' ')); break;
+        case 3: line += blank + string(gen() % 2 ? "c" : "s") + to_string(gen() % 3) + "x"; break;
+        case 4: line = line.substr(0, line.find(' ')) + " " + (gen() % 2 ? "c" : "s") +
+                       to_string(gen() % 2 ? scene.circles.size() : scene.squares.size()) + " c0 c0"; break;
+        case 5: line = line.substr(0, line.find(' ')) + " 1,5 2 c0"; break;
+        case 6: expected = ""; return (gen() % 2) ? "# " + line : string(blank);
+        case 7: return "  " + line + (gen() % 2 ? "\r" : "\t");
+        default: return line;
+    }
+    expected = "error\n";
+    return line;
+}
+
+// Ответы answerQueries и конвейера runBatchQueries совпадают с прямыми вызовами;
+// при minBytes больше блока чтения запросы повторяются, чтобы строки пересекали границы блоков
+static bool checkQueries(mt19937_64& gen, size_t minBytes, size_t& checks) {
+    Scene scene;
+    randomScene(gen, scene);
+    scene.circles.push_back(Circle{{uniform(gen, -10, 10), uniform(gen, -10, 10)}, uniform(gen, 0, 10)});
+    scene.squares.push_back(Square{{uniform(gen, -10, 10), uniform(gen, -10, 10)}, uniform(gen, 0, 10)});
+
+    string queries, expected, answer;
+    size_t expectedErrors = 0;
+    size_t count = 1 + gen() % 400;
+    for (size_t i = 0; i < count; ++i) {
+        queries += randomQuery(gen, scene, answer);
+        queries += '\n';
+        expected += answer;
+        expectedErrors += (answer == "error\n") ? 1 : 0;
+    }
+    size_t copies = minBytes / queries.size() + 1;
+    string repeated, repeatedAnswers;
+    for (size_t i = 0; i < copies; ++i) {
+        repeated += queries;
+        repeatedAnswers += expected;
+    }
+    queries.swap(repeated);
+    expected.swap(repeatedAnswers);
+    expectedErrors *= copies;
+    if (gen() % 2) {
+        queries.pop_back();  // последняя строка без перевода строки
+    }
+
+    string out;
+    size_t errors = answerQueries(scene, queries.data(), queries.data() + queries.size(), out);
+    ++checks;
+    if (out != expected || errors != expectedErrors) {
+        printf("MISMATCH answerQueries: %zu errors instead of %zu\n", errors, expectedErrors);
+        for (size_t line = 0, i = 0, j = 0; i < out.size() && j < expected.size(); ++line) {
+            size_t nextI = out.find('\n', i) + 1;
+            size_t nextJ = expected.find('\n', j) + 1;
+            if (out.compare(i, nextI - i, expected, j, nextJ - j) != 0) {
+                printf("  answer %zu: %s", line, out.substr(i, nextI - i).c_str());
+                break;
+            }
+            i = nextI;
+            j = nextJ;
+        }
+        return false;
+    }
+
+    FILE* input = tmpfile();
+    FILE* output = tmpfile();
+    if (input == nullptr || output == nullptr) {
+        if (input) fclose(input);
+        if (output) fclose(output);
+        return true;
+    }
+    fwrite(queries.data(), 1, queries.size(), input);
+    rewind(input);
+    size_t batchErrors = 0;
+    bool ok = runBatchQueries(scene, input, output, batchErrors);
+    rewind(output);
+    string batch(expected.size() + 1, '\0');
+    batch.resize(fread(&batch[0], 1, batch.size(), output));
+    fclose(input);
+    fclose(output);
+    ++checks;
+    if (!ok || batch != expected || batchErrors != expectedErrors) {
+        printf("MISMATCH runBatchQueries: %zu errors instead of %zu\n", batchErrors, expectedErrors);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t rounds = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 200;
+    unsigned long long seed = (argc > 2) ? strtoull(argv[2], nullptr, 10) : 1;
+    mt19937_64 gen(seed);
+
+    FuzzVisitor visitor;
+    visitor.gen = &gen;
+    visitor.checks = 0;
+    visitor.failures = 0;
+    size_t sceneFailures = 0;
+#ifndef _WIN32
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    string scenePath = (filesystem::temp_directory_path() / ("fuzz_scene_" + to_string(seed))).string();
+
+    for (size_t round = 0; round < rounds; ++round) {
+        // Масштаб координат меняется, чтобы EPSILON был соизмерим с ошибкой округления
+        double scale = pow(10.0, uniform(gen, -2.0, 4.0));
+        visitor.circle = Circle{{uniform(gen, -scale, scale), uniform(gen, -scale, scale)},
+                                uniform(gen, 0.01, 1.0) * scale};
+        visitor.square = Square{{uniform(gen, -scale, scale), uniform(gen, -scale, scale)},
+                                uniform(gen, 0.01, 2.0) * scale};
+        forEachPredicate(visitor);
+        if (!checkDynamicScene(gen, visitor.circle, visitor.square, visitor.checks)) {
+            ++sceneFailures;
+        }
+        if (!checkSceneFiles(gen, scenePath, visitor.checks)) {
+            ++sceneFailures;
+        }
+        if (!checkQueries(gen, (round % 20 == 0) ? (9 << 20) : 0, visitor.checks)) {
+            ++sceneFailures;
+        }
+        if (round % 20 == 0 && !checkParseErrorAtChunkBoundary(gen, visitor.checks)) {
+            ++sceneFailures;
+        }
+    }
+    error_code error;
+    filesystem::remove(scenePath, error);
+
+    printf("%zu checks, %zu mismatches\n", visitor.checks, visitor.failures + sceneFailures);
+    return (visitor.failures + sceneFailures == 0) ? 0 : 1;
+}
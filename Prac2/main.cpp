@@ -1,5 +1,11 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include "area.h"
 #include "func.h"
+#include "query.h"
+#include "scene.h"
 
 using namespace std;
 
@@ -93,7 +99,78 @@ void demonstrateContainment() {
     cout << "Circle1 inside Square1: " << (isCircleInsideSquare(c1, s1) ? "Yes" : "No") << endl;
 }
 
-int main() {
+// structs --convert input output [--text|--binary]
+int convertMode(int argc, char* argv[]) {
+    bool knownFormat = argc == 4 || (argc == 5 && (strcmp(argv[4], "--text") == 0 ||
+                                                   strcmp(argv[4], "--binary") == 0));
+    if (argc < 4 || !knownFormat) {
+        cerr << "Usage: " << argv[0] << " --convert input output [--text|--binary]" << endl;
+        return 1;
+    }
+    bool binaryOutput = argc == 4 || strcmp(argv[4], "--binary") == 0;
+    return convertSceneFile(argv[2], argv[3], binaryOutput) ? 0 : 1;
+}
+
+// structs --area scene [samples]
+int areaMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " --area scene [samples]" << endl;
+        return 1;
+    }
+    Scene scene;
+    if (!loadScene(argv[2], scene)) {
+        return 1;
+    }
+    cout << "Circles: " << scene.circles.size() << ", squares: " << scene.squares.size() << "\n";
+    cout << "Union area: " << sceneUnionArea(scene) << "\n";
+    if (argc > 3) {
+        size_t samples = strtoull(argv[3], nullptr, 10);
+        cout << "Monte Carlo estimate (" << samples << " samples): "
+             << monteCarloUnionArea(scene, samples) << "\n";
+    }
+    return 0;
+}
+
+// structs --batch scene [queries]  (без файла запросов читается stdin)
+int batchMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " --batch scene [queries]" << endl;
+        return 1;
+    }
+    Scene scene;
+    if (!loadScene(argv[2], scene)) {
+        return 1;
+    }
+    FILE* input = stdin;
+    if (argc > 3) {
+        input = fopen(argv[3], "rb");
+        if (input == nullptr) {
+            cerr << "Cannot open file: " << argv[3] << endl;
+            return 1;
+        }
+    }
+    size_t errors = 0;
+    bool ok = runBatchQueries(scene, input, stdout, errors);
+    if (input != stdin) {
+        fclose(input);
+    }
+    if (errors > 0) {
+        cerr << "Invalid queries: " << errors << endl;
+    }
+    return (ok && errors == 0) ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--convert") == 0) {
+        return convertMode(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--area") == 0) {
+        return areaMode(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        return batchMode(argc, argv);
+    }
+
     demonstratePoint();
     demonstrateCircle();
     demonstrateSquare();
@@ -0,0 +1,188 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Количество потоков для объема работы work, если на поток нужно не меньше minPerWorker единиц
+inline size_t workerCount(size_t work, size_t minPerWorker) {
+    size_t hardware = std::thread::hardware_concurrency();
+    if (hardware == 0) hardware = 1;
+    if (minPerWorker == 0) minPerWorker = 1;
+    size_t byWork = work / minPerWorker;
+    if (byWork == 0) byWork = 1;
+    return byWork < hardware ? byWork : hardware;
+}
+
+// Постоянный пул потоков: run() раздает номера частей работы потокам пула
+// и вызывающему потоку и возвращается, когда выполнены все части.
+// Задачи выполняются по одной; вызывать run() изнутри задачи нельзя
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads)
+        : task(nullptr), partCount(0), nextPart(0), busyWorkers(0), generation(0), stopping(false) {
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Общий пул: по одному потоку на ядро, считая вызывающий
+    static ThreadPool& instance() {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    void run(size_t parts, const std::function<void(size_t)>& partTask) {
+        if (workers.empty() || parts <= 1) {
+            for (size_t i = 0; i < parts; ++i) {
+                partTask(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(runMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &partTask;
+            partCount = parts;
+            nextPart = 0;
+            busyWorkers = workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return busyWorkers == 0; });
+        task = nullptr;
+    }
+
+private:
+    void work() {
+        for (;;) {
+            size_t part = nextPart.fetch_add(1);
+            if (part >= partCount) break;
+            (*task)(part);
+        }
+    }
+
+    void workerLoop() {
+        size_t seen = 0;
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            lock.unlock();
+
+            work();
+
+            lock.lock();
+            if (--busyWorkers == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)>* task;
+    size_t partCount;
+    std::atomic<size_t> nextPart;
+    size_t busyWorkers;
+    size_t generation;
+    bool stopping;
+};
+
+// Вызывает fn(part) для каждой части 0..parts-1 в общем пуле потоков
+// (вызывающий поток тоже выполняет части). Вложенные вызовы не допускаются
+template <typename Fn>
+void parallelFor(size_t parts, Fn fn) {
+    ThreadPool::instance().run(parts, [&fn](size_t part) { fn(part); });
+}
+
+// Один постоянный поток для фоновой работы (чтение и запись в конвейере):
+// start() передает ему задачу, wait() дожидается ее завершения
+class BackgroundThread {
+public:
+    BackgroundThread() : pending(false), stopping(false), thread([this]() { loop(); }) {}
+
+    ~BackgroundThread() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+
+    BackgroundThread(const BackgroundThread&) = delete;
+    BackgroundThread& operator=(const BackgroundThread&) = delete;
+
+    // Предыдущая задача должна быть завершена (wait)
+    void start(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = std::move(task);
+            pending = true;
+        }
+        wake.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return !pending; });
+    }
+
+private:
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [this]() { return stopping || pending; });
+            if (!pending) return;
+            lock.unlock();
+            job();
+            lock.lock();
+            pending = false;
+            done.notify_all();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function<void()> job;
+    bool pending;
+    bool stopping;
+    std::thread thread;
+};
+
+// Границы части part при делении count элементов на parts почти равных частей
+inline size_t chunkBegin(size_t count, size_t parts, size_t part) {
+    return count / parts * part + (part < count % parts ? part : count % parts);
+}
+
+#endif
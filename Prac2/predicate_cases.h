@@ -0,0 +1,318 @@
+#ifndef PREDICATE_CASES_H
+#define PREDICATE_CASES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include "func.h"
+#include "func_batch.h"
+
+// Общие для замеров (bench.cpp) и проверки (fuzz.cpp) генераторы входных данных
+// и список проверок: скалярная функция из func.h и ее пакетная версия из func_batch.h.
+// Входные данные бывают случайными или лежат у границы срабатывания проверки
+// (в пределах нескольких EPSILON)
+
+struct PointSet {
+    std::vector<double> x, y;
+};
+
+struct CircleSet {
+    std::vector<double> x, y, r;
+};
+
+struct SquareSet {
+    std::vector<double> x, y, side;
+};
+
+inline double uniform(std::mt19937_64& gen, double lo, double hi) {
+    return std::uniform_real_distribution<double>(lo, hi)(gen);
+}
+
+// Смещение от границы: до 3 EPSILON в обе стороны, часто ровно кратное EPSILON
+inline double boundaryOffset(std::mt19937_64& gen) {
+    double t = uniform(gen, -3.0, 3.0);
+    switch (gen() % 4) {
+        case 0: t = std::round(t); break;
+        case 1: t = std::nextafter(std::round(t), gen() % 2 ? 10.0 : -10.0); break;
+        default: break;
+    }
+    return t * EPSILON;
+}
+
+inline double pick(std::mt19937_64& gen, const double* values, size_t count) {
+    return values[gen() % count];
+}
+
+inline void randomPoints(std::mt19937_64& gen, size_t n, double extent, PointSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        out.x[i] = uniform(gen, -extent, extent);
+        out.y[i] = uniform(gen, -extent, extent);
+    }
+}
+
+inline void randomCircles(std::mt19937_64& gen, size_t n, double extent, CircleSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    out.r.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        out.x[i] = uniform(gen, -extent, extent);
+        out.y[i] = uniform(gen, -extent, extent);
+        out.r[i] = uniform(gen, 0.05, extent / 2);
+    }
+}
+
+inline void randomSquares(std::mt19937_64& gen, size_t n, double extent, SquareSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    out.side.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        out.x[i] = uniform(gen, -extent, extent);
+        out.y[i] = uniform(gen, -extent, extent);
+        out.side[i] = uniform(gen, 0.05, extent);
+    }
+}
+
+// Точки, у которых квадрат расстояния до центра отличается от r^2 на несколько EPSILON
+inline void pointsNearCircle(std::mt19937_64& gen, size_t n, const Circle& c, PointSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        double angle = uniform(gen, -M_PI, M_PI);
+        double distance = std::sqrt(std::max(0.0, c.radius * c.radius + boundaryOffset(gen)));
+        out.x[i] = c.center.x + distance * std::cos(angle);
+        out.y[i] = c.center.y + distance * std::sin(angle);
+    }
+}
+
+// Точки в нескольких EPSILON от сторон квадрата
+inline void pointsNearSquare(std::mt19937_64& gen, size_t n, const Square& s, PointSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    double xs[2] = {s.topLeft.x, s.topLeft.x + s.side};
+    double ys[2] = {s.topLeft.y - s.side, s.topLeft.y};
+    for (size_t i = 0; i < n; ++i) {
+        double along = uniform(gen, -3 * EPSILON, s.side + 3 * EPSILON);
+        if (gen() % 2) {
+            out.x[i] = pick(gen, xs, 2) + boundaryOffset(gen);
+            out.y[i] = ys[0] + along;
+        } else {
+            out.x[i] = xs[0] + along;
+            out.y[i] = pick(gen, ys, 2) + boundaryOffset(gen);
+        }
+    }
+}
+
+// Круги, расстояние от центра которых до центра c близко к r + R, |r - R| или R - r
+inline void circlesNearCircle(std::mt19937_64& gen, size_t n, const Circle& c, CircleSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    out.r.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        double r = uniform(gen, 0.05, 2 * c.radius);
+        double targets[2] = {r + c.radius, std::fabs(r - c.radius)};
+        double distance = std::max(0.0, pick(gen, targets, 2) + boundaryOffset(gen));
+        double angle = uniform(gen, -M_PI, M_PI);
+        out.x[i] = c.center.x + distance * std::cos(angle);
+        out.y[i] = c.center.y + distance * std::sin(angle);
+        out.r[i] = r;
+    }
+}
+
+// Квадраты, стороны которых совпадают со сторонами s с точностью до нескольких EPSILON
+inline void squaresNearSquare(std::mt19937_64& gen, size_t n, const Square& s, SquareSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    out.side.resize(n);
+    double left = s.topLeft.x;
+    double right = s.topLeft.x + s.side;
+    double top = s.topLeft.y;
+    double bottom = s.topLeft.y - s.side;
+    for (size_t i = 0; i < n; ++i) {
+        double side = uniform(gen, 0.05, 2 * s.side);
+        double xs[4] = {left - side, right, left, right - side};
+        double ys[4] = {top + side, bottom, top, bottom + side};
+        out.x[i] = pick(gen, xs, 4) + boundaryOffset(gen);
+        out.y[i] = pick(gen, ys, 4) + boundaryOffset(gen);
+        out.side[i] = side;
+    }
+}
+
+// Круги, касающиеся сторон или углов квадрата s с точностью до нескольких EPSILON
+inline void circlesNearSquare(std::mt19937_64& gen, size_t n, const Square& s, CircleSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    out.r.resize(n);
+    double left = s.topLeft.x;
+    double right = s.topLeft.x + s.side;
+    double top = s.topLeft.y;
+    double bottom = s.topLeft.y - s.side;
+    for (size_t i = 0; i < n; ++i) {
+        double r = uniform(gen, 0.05, s.side);
+        if (gen() % 3 == 0) {
+            double cornersX[2] = {left, right};
+            double cornersY[2] = {bottom, top};
+            double angle = uniform(gen, -M_PI, M_PI);
+            double distance = std::max(0.0, r + boundaryOffset(gen));
+            out.x[i] = pick(gen, cornersX, 2) + distance * std::cos(angle);
+            out.y[i] = pick(gen, cornersY, 2) + distance * std::sin(angle);
+        } else {
+            double xs[4] = {left - r, right + r, left + r, right - r};
+            double ys[4] = {bottom - r, top + r, bottom + r, top - r};
+            out.x[i] = pick(gen, xs, 4) + boundaryOffset(gen);
+            out.y[i] = pick(gen, ys, 4) + boundaryOffset(gen);
+        }
+        out.r[i] = r;
+    }
+}
+
+// Квадраты, углы которых лежат на окружности c с точностью до нескольких EPSILON
+inline void squaresNearCircle(std::mt19937_64& gen, size_t n, const Circle& c, SquareSet& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    out.side.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        double side = uniform(gen, 0.05, c.radius * std::sqrt(2.0));
+        double angle = uniform(gen, -M_PI, M_PI);
+        double distance = std::sqrt(std::max(0.0, c.radius * c.radius + boundaryOffset(gen)));
+        double cornerX = c.center.x + distance * std::cos(angle);
+        double cornerY = c.center.y + distance * std::sin(angle);
+        // Угол на окружности выбирается так, чтобы квадрат лежал в сторону центра
+        out.x[i] = (std::cos(angle) > 0) ? cornerX - side : cornerX;
+        out.y[i] = (std::sin(angle) > 0) ? cornerY : cornerY + side;
+        out.side[i] = side;
+    }
+}
+
+enum InputKind { POINT_INPUT, CIRCLE_INPUT, SQUARE_INPUT };
+
+// Входные массивы SoA; заполнен набор, соответствующий InputKind проверки
+struct PredicateInputs {
+    PointSet points;
+    CircleSet circles;
+    SquareSet squares;
+};
+
+// Заполняет входы для проверки с первым аргументом kind и вторым c (againstCircle) или s
+inline void makeInputs(std::mt19937_64& gen, size_t n, InputKind kind, bool againstCircle, bool boundary,
+                       const Circle& c, const Square& s, PredicateInputs& inputs) {
+    double extent = 2 * std::max(c.radius, s.side) + std::fabs(c.center.x) + std::fabs(s.topLeft.x);
+    switch (kind) {
+        case POINT_INPUT:
+            if (!boundary) randomPoints(gen, n, extent, inputs.points);
+            else if (againstCircle) pointsNearCircle(gen, n, c, inputs.points);
+            else pointsNearSquare(gen, n, s, inputs.points);
+            break;
+        case CIRCLE_INPUT:
+            if (!boundary) randomCircles(gen, n, extent, inputs.circles);
+            else if (againstCircle) circlesNearCircle(gen, n, c, inputs.circles);
+            else circlesNearSquare(gen, n, s, inputs.circles);
+            break;
+        case SQUARE_INPUT:
+            if (!boundary) randomSquares(gen, n, extent, inputs.squares);
+            else if (againstCircle) squaresNearCircle(gen, n, c, inputs.squares);
+            else squaresNearSquare(gen, n, s, inputs.squares);
+            break;
+    }
+}
+
+inline Point inputPoint(const PredicateInputs& in, size_t i) {
+    return Point{in.points.x[i], in.points.y[i]};
+}
+
+inline Circle inputCircle(const PredicateInputs& in, size_t i) {
+    return Circle{{in.circles.x[i], in.circles.y[i]}, in.circles.r[i]};
+}
+
+inline Square inputSquare(const PredicateInputs& in, size_t i) {
+    return Square{{in.squares.x[i], in.squares.y[i]}, in.squares.side[i]};
+}
+
+// Вызывает visitor.run(name, kind, againstCircle, scalar, batch) для каждой проверки, где
+//   scalar(inputs, i, c, s) - результат скалярной функции для i-го входа,
+//   batch(inputs, n, c, s, out) - результаты пакетной версии для n входов
+template <typename Visitor>
+void forEachPredicate(Visitor& visitor) {
+    visitor.run("isPointInsideCircle", POINT_INPUT, true,
+        [](const PredicateInputs& in, size_t i, const Circle& c, const Square&) {
+            return isPointInsideCircle(inputPoint(in, i), c);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle& c, const Square&, unsigned char* out) {
+            pointsInsideCircle(in.points.x.data(), in.points.y.data(), n, c, out);
+        });
+    visitor.run("isPointInsideSquare", POINT_INPUT, false,
+        [](const PredicateInputs& in, size_t i, const Circle&, const Square& s) {
+            return isPointInsideSquare(inputPoint(in, i), s);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle&, const Square& s, unsigned char* out) {
+            pointsInsideSquare(in.points.x.data(), in.points.y.data(), n, s, out);
+        });
+    visitor.run("isPointOnCircle", POINT_INPUT, true,
+        [](const PredicateInputs& in, size_t i, const Circle& c, const Square&) {
+            return isPointOnCircle(inputPoint(in, i), c);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle& c, const Square&, unsigned char* out) {
+            pointsOnCircle(in.points.x.data(), in.points.y.data(), n, c, out);
+        });
+    visitor.run("isPointOnSquare", POINT_INPUT, false,
+        [](const PredicateInputs& in, size_t i, const Circle&, const Square& s) {
+            return isPointOnSquare(inputPoint(in, i), s);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle&, const Square& s, unsigned char* out) {
+            pointsOnSquare(in.points.x.data(), in.points.y.data(), n, s, out);
+        });
+    visitor.run("circlesIntersect", CIRCLE_INPUT, true,
+        [](const PredicateInputs& in, size_t i, const Circle& c, const Square&) {
+            return circlesIntersect(inputCircle(in, i), c);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle& c, const Square&, unsigned char* out) {
+            circlesIntersectCircle(in.circles.x.data(), in.circles.y.data(), in.circles.r.data(), n, c, out);
+        });
+    visitor.run("squaresIntersect", SQUARE_INPUT, false,
+        [](const PredicateInputs& in, size_t i, const Circle&, const Square& s) {
+            return squaresIntersect(inputSquare(in, i), s);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle&, const Square& s, unsigned char* out) {
+            squaresIntersectSquare(in.squares.x.data(), in.squares.y.data(), in.squares.side.data(), n, s, out);
+        });
+    visitor.run("circleSquareIntersect", CIRCLE_INPUT, false,
+        [](const PredicateInputs& in, size_t i, const Circle&, const Square& s) {
+            return circleSquareIntersect(inputCircle(in, i), s);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle&, const Square& s, unsigned char* out) {
+            circlesIntersectSquare(in.circles.x.data(), in.circles.y.data(), in.circles.r.data(), n, s, out);
+        });
+    visitor.run("isCircleInsideCircle", CIRCLE_INPUT, true,
+        [](const PredicateInputs& in, size_t i, const Circle& c, const Square&) {
+            return isCircleInsideCircle(inputCircle(in, i), c);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle& c, const Square&, unsigned char* out) {
+            circlesInsideCircle(in.circles.x.data(), in.circles.y.data(), in.circles.r.data(), n, c, out);
+        });
+    visitor.run("isSquareInsideSquare", SQUARE_INPUT, false,
+        [](const PredicateInputs& in, size_t i, const Circle&, const Square& s) {
+            return isSquareInsideSquare(inputSquare(in, i), s);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle&, const Square& s, unsigned char* out) {
+            squaresInsideSquare(in.squares.x.data(), in.squares.y.data(), in.squares.side.data(), n, s, out);
+        });
+    visitor.run("isSquareInsideCircle", SQUARE_INPUT, true,
+        [](const PredicateInputs& in, size_t i, const Circle& c, const Square&) {
+            return isSquareInsideCircle(inputSquare(in, i), c);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle& c, const Square&, unsigned char* out) {
+            squaresInsideCircle(in.squares.x.data(), in.squares.y.data(), in.squares.side.data(), n, c, out);
+        });
+    visitor.run("isCircleInsideSquare", CIRCLE_INPUT, false,
+        [](const PredicateInputs& in, size_t i, const Circle&, const Square& s) {
+            return isCircleInsideSquare(inputCircle(in, i), s);
+        },
+        [](const PredicateInputs& in, size_t n, const Circle&, const Square& s, unsigned char* out) {
+            circlesInsideSquare(in.circles.x.data(), in.circles.y.data(), in.circles.r.data(), n, s, out);
+        });
+}
+
+#endif
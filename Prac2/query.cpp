@@ -0,0 +1,226 @@
+#include "query.h"
+#include "func.h"
+#include "parallel.h"
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Размер блока, читаемого из входного потока за один раз
+const size_t BATCH_BLOCK_BYTES = 4 << 20;
+
+// Минимальный объем запросов на один поток
+const size_t BATCH_CHUNK_BYTES = 64 << 10;
+
+struct ShapeRef {
+    bool isCircle;
+    size_t index;
+};
+
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+static string_view parseWord(const char*& p, const char* end) {
+    p = skipBlanks(p, end);
+    const char* start = p;
+    while (p < end && !isBlank(*p)) ++p;
+    return string_view(start, p - start);
+}
+
+static bool parseDouble(const char*& p, const char* end, double& value) {
+    p = skipBlanks(p, end);
+    from_chars_result result = from_chars(p, end, value);
+    if (result.ec != errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+static bool parseShapeRef(const char*& p, const char* end, const Scene& scene, ShapeRef& ref) {
+    p = skipBlanks(p, end);
+    if (p == end || (*p != 'c' && *p != 's')) return false;
+    ref.isCircle = (*p++ == 'c');
+    from_chars_result result = from_chars(p, end, ref.index);
+    if (result.ec != errc()) return false;
+    p = result.ptr;
+    return ref.index < (ref.isCircle ? scene.circles.size() : scene.squares.size());
+}
+
+static bool intersect(const Scene& scene, const ShapeRef& a, const ShapeRef& b) {
+    if (a.isCircle && b.isCircle) return circlesIntersect(scene.circles[a.index], scene.circles[b.index]);
+    if (!a.isCircle && !b.isCircle) return squaresIntersect(scene.squares[a.index], scene.squares[b.index]);
+    if (a.isCircle) return circleSquareIntersect(scene.circles[a.index], scene.squares[b.index]);
+    return circleSquareIntersect(scene.circles[b.index], scene.squares[a.index]);
+}
+
+// inner лежит внутри outer
+static bool inside(const Scene& scene, const ShapeRef& inner, const ShapeRef& outer) {
+    if (inner.isCircle && outer.isCircle) return isCircleInsideCircle(scene.circles[inner.index], scene.circles[outer.index]);
+    if (!inner.isCircle && !outer.isCircle) return isSquareInsideSquare(scene.squares[inner.index], scene.squares[outer.index]);
+    if (inner.isCircle) return isCircleInsideSquare(scene.circles[inner.index], scene.squares[outer.index]);
+    return isSquareInsideCircle(scene.squares[inner.index], scene.circles[outer.index]);
+}
+
+// Ответ на одну строку запроса: 1 или 0, -1 для ошибочной строки
+static int answerQuery(const Scene& scene, const char* p, const char* end) {
+    string_view command = parseWord(p, end);
+    Point point;
+    ShapeRef a, b;
+    int answer;
+    if (command == "in" || command == "on") {
+        if (!parseDouble(p, end, point.x) || !parseDouble(p, end, point.y) ||
+            !parseShapeRef(p, end, scene, a)) {
+            return -1;
+        }
+        if (command == "on") {
+            answer = a.isCircle ? isPointOnCircle(point, scene.circles[a.index])
+                                : isPointOnSquare(point, scene.squares[a.index]);
+        } else {
+            answer = a.isCircle ? isPointInsideCircle(point, scene.circles[a.index])
+                                : isPointInsideSquare(point, scene.squares[a.index]);
+        }
+    } else if (command == "intersect" || command == "contains") {
+        if (!parseShapeRef(p, end, scene, a) || !parseShapeRef(p, end, scene, b)) {
+            return -1;
+        }
+        answer = (command == "intersect") ? intersect(scene, a, b) : inside(scene, b, a);
+    } else {
+        return -1;
+    }
+    return skipBlanks(p, end) == end ? answer : -1;
+}
+
+size_t answerQueries(const Scene& scene, const char* begin, const char* end, string& out) {
+    size_t errors = 0;
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) lineEnd = end;
+        const char* q = skipBlanks(p, lineEnd);
+        if (q < lineEnd && *q != '#') {
+            int answer = answerQuery(scene, q, lineEnd);
+            if (answer < 0) {
+                out.append("error\n");
+                ++errors;
+            } else {
+                out.push_back(answer ? '1' : '0');
+                out.push_back('\n');
+            }
+        }
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+    return errors;
+}
+
+// Читает очередной блок из целых строк; неполная последняя строка переносится в carry.
+// Возвращает true, если входной поток закончился
+static bool readBlock(FILE* input, vector<char>& carry, vector<char>& block) {
+    block.swap(carry);
+    carry.clear();
+    size_t old = block.size();
+    block.resize(old + BATCH_BLOCK_BYTES);
+    size_t n = fread(block.data() + old, 1, BATCH_BLOCK_BYTES, input);
+    block.resize(old + n);
+    if (n < BATCH_BLOCK_BYTES) {
+        return true;
+    }
+
+    size_t keep = block.size();
+    while (keep > 0 && block[keep - 1] != '\n') --keep;
+    carry.assign(block.begin() + keep, block.end());
+    block.resize(keep);
+    return false;
+}
+
+// Отвечает на запросы блока, разбивая его по строкам между потоками
+static size_t processBlock(const Scene& scene, const vector<char>& block, string& out) {
+    out.clear();
+    const char* begin = block.data();
+    const char* end = begin + block.size();
+    size_t parts = workerCount(block.size(), BATCH_CHUNK_BYTES);
+    if (parts <= 1) {
+        return answerQueries(scene, begin, end, out);
+    }
+
+    vector<const char*> bounds(parts + 1, end);
+    bounds[0] = begin;
+    for (size_t part = 1; part < parts; ++part) {
+        const char* p = begin + chunkBegin(block.size(), parts, part);
+        if (p < bounds[part - 1]) p = bounds[part - 1];
+        const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+        bounds[part] = newline ? newline + 1 : end;
+    }
+
+    vector<string> answers(parts);
+    vector<size_t> errors(parts, 0);
+    parallelFor(parts, [&](size_t part) {
+        answers[part].reserve((bounds[part + 1] - bounds[part]) / 8);
+        errors[part] = answerQueries(scene, bounds[part], bounds[part + 1], answers[part]);
+    });
+
+    size_t total = 0;
+    size_t length = 0;
+    for (size_t part = 0; part < parts; ++part) {
+        total += errors[part];
+        length += answers[part].size();
+    }
+    out.reserve(length);
+    for (size_t part = 0; part < parts; ++part) {
+        out.append(answers[part]);
+    }
+    return total;
+}
+
+static bool writeAll(FILE* output, const string& data) {
+    return fwrite(data.data(), 1, data.size(), output) == data.size();
+}
+
+bool runBatchQueries(const Scene& scene, FILE* input, FILE* output, size_t& errors) {
+    errors = 0;
+    vector<char> carry, current, next;
+    string produced, written;
+    bool ok = true;
+    bool writeOk = true;
+    bool nextFinished = false;
+    // Чтение и запись идут в постоянных потоках, разбор блока - в общем пуле
+    BackgroundThread reader, writer;
+
+    bool finished = readBlock(input, carry, current);
+    for (;;) {
+        if (!finished) {
+            reader.start([&]() { nextFinished = readBlock(input, carry, next); });
+        }
+
+        errors += processBlock(scene, current, produced);
+
+        writer.wait();
+        if (!writeOk) {
+            ok = false;
+        }
+        written.swap(produced);
+        writer.start([&]() { writeOk = writeAll(output, written); });
+
+        if (finished) break;
+        reader.wait();
+        finished = nextFinished;
+        current.swap(next);
+    }
+    writer.wait();
+    if (!writeOk || fflush(output) != 0) {
+        cerr << "Error writing answers" << endl;
+        ok = false;
+    }
+    if (ferror(input)) {
+        cerr << "Error reading queries" << endl;
+        ok = false;
+    }
+    return ok;
+}
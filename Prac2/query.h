@@ -0,0 +1,27 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include "scene.h"
+
+// Пакетные запросы к сцене, по одному в строке:
+//   in x y ID        - точка строго внутри фигуры ID
+//   on x y ID        - точка на контуре фигуры ID
+//   intersect ID ID  - фигуры пересекаются
+//   contains ID ID   - вторая фигура лежит внутри первой
+// ID - c<номер> для круга или s<номер> для квадрата (номера с нуля в порядке файла сцены).
+// На каждый запрос выводится строка 1, 0 или error; пустые строки и строки,
+// начинающиеся с '#', пропускаются без ответа
+
+// Отвечает на запросы из целых строк [begin, end), ответы дописываются в out.
+// Возвращает число ошибочных запросов
+size_t answerQueries(const Scene& scene, const char* begin, const char* end, std::string& out);
+
+// Читает запросы из input блоками и пишет ответы в output в порядке запросов.
+// Чтение следующего блока, обработка текущего (в нескольких потоках) и запись
+// предыдущего идут одновременно
+bool runBatchQueries(const Scene& scene, FILE* input, FILE* output, size_t& errors);
+
+#endif
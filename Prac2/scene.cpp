@@ -0,0 +1,410 @@
+#include "scene.h"
+#include "parallel.h"
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const char SCENE_MAGIC[4] = {'S', 'C', 'N', '1'};
+
+// Результат разбора одного куска текстового файла
+struct ParsedChunk {
+    Scene scene;
+    size_t lines;
+    size_t errorLine;
+    bool ok;
+};
+
+// Блок чтения файлов, размер которых заранее неизвестен (каналы, устройства)
+const size_t READ_BLOCK_BYTES = 1 << 16;
+
+static bool isRegularFile(const string& filename) {
+    error_code error;
+    return filesystem::is_regular_file(filename, error);
+}
+
+static bool readWholeFile(const string& filename, vector<char>& buffer) {
+    error_code error;
+    if (filesystem::is_directory(filename, error)) {
+        cerr << "Not a file: " << filename << endl;
+        return false;
+    }
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Cannot open file: " << filename << endl;
+        return false;
+    }
+
+    buffer.clear();
+    if (isRegularFile(filename) && file.seekg(0, ios::end)) {
+        streamoff size = file.tellg();
+        if (size >= 0 && file.seekg(0, ios::beg)) {
+            buffer.resize(static_cast<size_t>(size));
+            if (size > 0 && !file.read(buffer.data(), size)) {
+                cerr << "Error reading file: " << filename << endl;
+                return false;
+            }
+            return true;
+        }
+    }
+
+    // Размер неизвестен: чтение блоками до конца файла
+    file.clear();
+    for (;;) {
+        size_t used = buffer.size();
+        buffer.resize(used + READ_BLOCK_BYTES);
+        file.read(buffer.data() + used, READ_BLOCK_BYTES);
+        buffer.resize(used + static_cast<size_t>(file.gcount()));
+        if (!file) break;
+    }
+    if (file.bad()) {
+        cerr << "Error reading file: " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+static const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+static bool parseNumbers(const char*& p, const char* end, double* values, int count) {
+    for (int i = 0; i < count; ++i) {
+        p = skipBlanks(p, end);
+        from_chars_result result = from_chars(p, end, values[i]);
+        if (result.ec != errc()) return false;
+        p = result.ptr;
+    }
+    return true;
+}
+
+static void parseChunk(const char* p, const char* end, ParsedChunk& chunk) {
+    chunk.lines = 0;
+    chunk.errorLine = 0;
+    chunk.ok = true;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) lineEnd = end;
+        ++chunk.lines;
+
+        const char* q = skipBlanks(p, lineEnd);
+        if (q < lineEnd && *q != '#') {
+            char kind = *q++;
+            double v[3];
+            bool valid = (kind == 'C' || kind == 'c' || kind == 'S' || kind == 's') &&
+                         parseNumbers(q, lineEnd, v, 3) && skipBlanks(q, lineEnd) == lineEnd;
+            if (!valid) {
+                chunk.ok = false;
+                chunk.errorLine = chunk.lines;
+                return;
+            }
+            if (kind == 'C' || kind == 'c') {
+                chunk.scene.circles.push_back(Circle{{v[0], v[1]}, v[2]});
+            } else {
+                chunk.scene.squares.push_back(Square{{v[0], v[1]}, v[2]});
+            }
+        }
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+}
+
+// Текст делится на куски по границам строк, куски разбираются параллельно
+bool parseSceneText(const char* begin, const char* end, Scene& scene) {
+    size_t size = end - begin;
+    size_t parts = workerCount(size, PARSE_CHUNK_BYTES);
+
+    vector<const char*> bounds(parts + 1, end);
+    bounds[0] = begin;
+    for (size_t part = 1; part < parts; ++part) {
+        const char* p = begin + chunkBegin(size, parts, part);
+        if (p < bounds[part - 1]) p = bounds[part - 1];
+        const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+        bounds[part] = newline ? newline + 1 : end;
+    }
+
+    vector<ParsedChunk> chunks(parts);
+    parallelFor(parts, [&](size_t part) {
+        parseChunk(bounds[part], bounds[part + 1], chunks[part]);
+    });
+
+    size_t circleCount = 0;
+    size_t squareCount = 0;
+    size_t linesBefore = 0;
+    for (size_t part = 0; part < parts; ++part) {
+        if (!chunks[part].ok) {
+            cerr << "Invalid shape record at line " << linesBefore + chunks[part].errorLine << endl;
+            return false;
+        }
+        linesBefore += chunks[part].lines;
+        circleCount += chunks[part].scene.circles.size();
+        squareCount += chunks[part].scene.squares.size();
+    }
+
+    Scene result;
+    result.circles.reserve(circleCount);
+    result.squares.reserve(squareCount);
+    for (size_t part = 0; part < parts; ++part) {
+        const Scene& parsed = chunks[part].scene;
+        result.circles.insert(result.circles.end(), parsed.circles.begin(), parsed.circles.end());
+        result.squares.insert(result.squares.end(), parsed.squares.begin(), parsed.squares.end());
+    }
+    scene = move(result);
+    return true;
+}
+
+bool loadSceneText(const string& filename, Scene& scene) {
+    vector<char> buffer;
+    if (!readWholeFile(filename, buffer)) {
+        return false;
+    }
+    return parseSceneText(buffer.data(), buffer.data() + buffer.size(), scene);
+}
+
+static void appendShape(string& out, char kind, double a, double b, double c) {
+    char line[128];
+    char* p = line;
+    char* end = line + sizeof(line);
+    *p++ = kind;
+    double values[3] = {a, b, c};
+    for (int i = 0; i < 3; ++i) {
+        *p++ = ' ';
+        p = to_chars(p, end, values[i]).ptr;
+    }
+    *p++ = '\n';
+    out.append(line, p);
+}
+
+bool saveSceneText(const string& filename, const Scene& scene) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Cannot create file: " << filename << endl;
+        return false;
+    }
+
+    string out;
+    out.reserve((scene.circles.size() + scene.squares.size()) * 48);
+    for (size_t i = 0; i < scene.circles.size(); ++i) {
+        const Circle& c = scene.circles[i];
+        appendShape(out, 'C', c.center.x, c.center.y, c.radius);
+    }
+    for (size_t i = 0; i < scene.squares.size(); ++i) {
+        const Square& s = scene.squares[i];
+        appendShape(out, 'S', s.topLeft.x, s.topLeft.y, s.side);
+    }
+    file.write(out.data(), out.size());
+    return file.good();
+}
+
+bool saveSceneBinary(const string& filename, const Scene& scene) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Cannot create file: " << filename << endl;
+        return false;
+    }
+
+    SceneHeader header;
+    memcpy(header.magic, SCENE_MAGIC, sizeof(header.magic));
+    header.version = SCENE_BINARY_VERSION;
+    header.circleCount = scene.circles.size();
+    header.squareCount = scene.squares.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    size_t count = max(scene.circles.size(), scene.squares.size());
+    vector<double> column(count);
+    const size_t bytesCircles = scene.circles.size() * sizeof(double);
+    const size_t bytesSquares = scene.squares.size() * sizeof(double);
+
+    for (size_t i = 0; i < scene.circles.size(); ++i) column[i] = scene.circles[i].center.x;
+    file.write(reinterpret_cast<const char*>(column.data()), bytesCircles);
+    for (size_t i = 0; i < scene.circles.size(); ++i) column[i] = scene.circles[i].center.y;
+    file.write(reinterpret_cast<const char*>(column.data()), bytesCircles);
+    for (size_t i = 0; i < scene.circles.size(); ++i) column[i] = scene.circles[i].radius;
+    file.write(reinterpret_cast<const char*>(column.data()), bytesCircles);
+
+    for (size_t i = 0; i < scene.squares.size(); ++i) column[i] = scene.squares[i].topLeft.x;
+    file.write(reinterpret_cast<const char*>(column.data()), bytesSquares);
+    for (size_t i = 0; i < scene.squares.size(); ++i) column[i] = scene.squares[i].topLeft.y;
+    file.write(reinterpret_cast<const char*>(column.data()), bytesSquares);
+    for (size_t i = 0; i < scene.squares.size(); ++i) column[i] = scene.squares[i].side;
+    file.write(reinterpret_cast<const char*>(column.data()), bytesSquares);
+
+    return file.good();
+}
+
+// Проверка заголовка двоичной сцены в памяти и разметка массивов SoA
+static bool viewSceneBinary(const unsigned char* data, size_t length, const string& filename, SceneView& view) {
+    if (length < sizeof(SceneHeader)) {
+        cerr << "Scene file is too short: " << filename << endl;
+        return false;
+    }
+
+    const SceneHeader* header = reinterpret_cast<const SceneHeader*>(data);
+    if (memcmp(header->magic, SCENE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SCENE_BINARY_VERSION) {
+        cerr << "Unsupported scene format: " << filename << endl;
+        return false;
+    }
+
+    const uint64_t maxValues = (length - sizeof(SceneHeader)) / sizeof(double);
+    if (header->circleCount > maxValues / 3 || header->squareCount > maxValues / 3 ||
+        3 * (header->circleCount + header->squareCount) > maxValues) {
+        cerr << "Scene file is truncated: " << filename << endl;
+        return false;
+    }
+
+    const double* values = reinterpret_cast<const double*>(data + sizeof(SceneHeader));
+    view.circleCount = static_cast<size_t>(header->circleCount);
+    view.circleX = values;
+    view.circleY = view.circleX + view.circleCount;
+    view.circleRadius = view.circleY + view.circleCount;
+    view.squareCount = static_cast<size_t>(header->squareCount);
+    view.squareX = view.circleRadius + view.circleCount;
+    view.squareY = view.squareX + view.squareCount;
+    view.squareSide = view.squareY + view.squareCount;
+    return true;
+}
+
+static void sceneFromView(const SceneView& view, Scene& scene) {
+    scene.circles.resize(view.circleCount);
+    for (size_t i = 0; i < view.circleCount; ++i) {
+        scene.circles[i] = sceneCircle(view, i);
+    }
+    scene.squares.resize(view.squareCount);
+    for (size_t i = 0; i < view.squareCount; ++i) {
+        scene.squares[i] = sceneSquare(view, i);
+    }
+}
+
+bool loadSceneBinary(const string& filename, Scene& scene) {
+    MappedScene mapped;
+    if (!mapped.open(filename)) {
+        return false;
+    }
+    mapped.toScene(scene);
+    return true;
+}
+
+static bool isBinarySceneFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    char magic[4];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, SCENE_MAGIC, sizeof(magic)) == 0;
+}
+
+bool loadScene(const string& filename, Scene& scene) {
+    if (isRegularFile(filename)) {
+        if (isBinarySceneFile(filename)) {
+            return loadSceneBinary(filename, scene);
+        }
+        return loadSceneText(filename, scene);
+    }
+
+    // Канал можно прочитать только один раз: формат определяется по уже прочитанным данным
+    vector<char> buffer;
+    if (!readWholeFile(filename, buffer)) {
+        return false;
+    }
+    if (buffer.size() >= sizeof(SCENE_MAGIC) && memcmp(buffer.data(), SCENE_MAGIC, sizeof(SCENE_MAGIC)) == 0) {
+        SceneView view;
+        if (!viewSceneBinary(reinterpret_cast<const unsigned char*>(buffer.data()), buffer.size(), filename, view)) {
+            return false;
+        }
+        sceneFromView(view, scene);
+        return true;
+    }
+    return parseSceneText(buffer.data(), buffer.data() + buffer.size(), scene);
+}
+
+bool convertSceneFile(const string& input, const string& output, bool binaryOutput) {
+    Scene scene;
+    if (!loadScene(input, scene)) {
+        return false;
+    }
+    return binaryOutput ? saveSceneBinary(output, scene) : saveSceneText(output, scene);
+}
+
+Circle sceneCircle(const SceneView& view, size_t i) {
+    return Circle{{view.circleX[i], view.circleY[i]}, view.circleRadius[i]};
+}
+
+Square sceneSquare(const SceneView& view, size_t i) {
+    return Square{{view.squareX[i], view.squareY[i]}, view.squareSide[i]};
+}
+
+MappedScene::MappedScene() : base(nullptr), length(0), arrays() {}
+
+MappedScene::~MappedScene() {
+    close();
+}
+
+bool MappedScene::open(const string& filename) {
+    close();
+
+#ifdef _WIN32
+    vector<char> buffer;
+    if (!readWholeFile(filename, buffer)) {
+        return false;
+    }
+    fallback.assign(buffer.begin(), buffer.end());
+    length = fallback.size();
+    const unsigned char* data = fallback.data();
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Cannot open file: " << filename << endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        cerr << "Cannot stat file: " << filename << endl;
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    const unsigned char* data = nullptr;
+    if (length >= sizeof(SceneHeader)) {
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            cerr << "Cannot map file: " << filename << endl;
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        data = static_cast<const unsigned char*>(mapping);
+    }
+    ::close(fd);
+#endif
+
+    base = data;
+    if (!viewSceneBinary(base, length, filename, arrays)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedScene::close() {
+#ifndef _WIN32
+    if (base != nullptr) {
+        munmap(const_cast<unsigned char*>(base), length);
+    }
+#endif
+    fallback.clear();
+    base = nullptr;
+    length = 0;
+    arrays = SceneView();
+}
+
+void MappedScene::toScene(Scene& scene) const {
+    sceneFromView(arrays, scene);
+}
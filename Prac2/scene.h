@@ -0,0 +1,86 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "structs.h"
+
+// Набор фигур, загруженных из файла
+struct Scene {
+    std::vector<Circle> circles;
+    std::vector<Square> squares;
+};
+
+// Текстовый формат: одна фигура в строке
+//   C center_x center_y radius
+//   S topLeft_x topLeft_y side
+// Пустые строки и строки, начинающиеся с '#', пропускаются.
+// Все функции загрузки заменяют содержимое scene; при ошибке оно не меняется.
+// Текст больше PARSE_CHUNK_BYTES делится по строкам и разбирается в нескольких потоках
+const size_t PARSE_CHUNK_BYTES = 1 << 20;
+
+bool parseSceneText(const char* begin, const char* end, Scene& scene);
+bool loadSceneText(const std::string& filename, Scene& scene);
+bool saveSceneText(const std::string& filename, const Scene& scene);
+
+// Двоичный формат: заголовок, затем массивы SoA из double в порядке
+// circleX, circleY, circleRadius, squareX, squareY, squareSide
+// (порядок байтов платформы, все массивы выровнены на 8 байт)
+const uint32_t SCENE_BINARY_VERSION = 1;
+
+struct SceneHeader {
+    char magic[4];  // "SCN1"
+    uint32_t version;
+    uint64_t circleCount;
+    uint64_t squareCount;
+};
+
+bool saveSceneBinary(const std::string& filename, const Scene& scene);
+bool loadSceneBinary(const std::string& filename, Scene& scene);
+
+// Загрузка с определением формата по сигнатуре файла
+bool loadScene(const std::string& filename, Scene& scene);
+
+// Преобразование файла сцены в другой формат
+bool convertSceneFile(const std::string& input, const std::string& output, bool binaryOutput);
+
+// Представление сцены в виде массивов SoA без копирования
+struct SceneView {
+    size_t circleCount;
+    const double* circleX;
+    const double* circleY;
+    const double* circleRadius;
+    size_t squareCount;
+    const double* squareX;
+    const double* squareY;
+    const double* squareSide;
+};
+
+Circle sceneCircle(const SceneView& view, size_t i);
+Square sceneSquare(const SceneView& view, size_t i);
+
+// Двоичный файл сцены, отображенный в память (используется на месте)
+class MappedScene {
+public:
+    MappedScene();
+    ~MappedScene();
+    MappedScene(const MappedScene&) = delete;
+    MappedScene& operator=(const MappedScene&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    const SceneView& view() const { return arrays; }
+    void toScene(Scene& scene) const;
+
+private:
+    const unsigned char* base;
+    size_t length;
+    std::vector<unsigned char> fallback;
+    SceneView arrays;
+};
+
+#endif